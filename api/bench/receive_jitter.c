@@ -0,0 +1,318 @@
+/**
+ * @file receive_jitter.c
+ * @brief Measures how long received frames wait for their callback while
+ *        busy threads compete for the receive threads' core, first with the
+ *        receive threads at normal priority and then with
+ *        \ref oscc_set_receive_realtime. Frames come from a local socket in
+ *        place of a CAN bus, so no hardware is needed. Requires a build with
+ *        -DOSCC_STATS=ON.
+ *
+ */
+
+
+#define _GNU_SOURCE
+
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oscc.h"
+#include "internal/oscc.h"
+
+
+// Any standard ID does, the frames only reach the bench's handler
+#define BENCH_CAN_ID ( 0x123 )
+
+#define BENCH_PRIORITY_DEFAULT ( 50 )
+
+
+typedef struct
+{
+    unsigned int frames;
+    unsigned int interval_us;
+    unsigned int load_threads;
+    int priority;
+    int cpu;
+} bench_options_s;
+
+
+static atomic_bool global_loading = true;
+
+
+static void bench_handler(
+    const struct can_frame * frame,
+    const struct timespec * timestamp,
+    void * user_data )
+{
+    (void) frame;
+    (void) timestamp;
+    (void) user_data;
+}
+
+static void * bench_load_thread( void * arg )
+{
+    volatile unsigned long spins = 0;
+
+    (void) arg;
+
+    while ( atomic_load_explicit( &global_loading, memory_order_relaxed ) )
+    {
+        spins++;
+    }
+
+    return NULL;
+}
+
+// Upper bound of the bucket holding the given fraction of the samples, or
+// the largest sample if that is lower
+static uint64_t bench_percentile(
+    const oscc_stats_s * const stats,
+    const oscc_histogram_s * const histogram,
+    double fraction )
+{
+    const uint64_t target = (uint64_t) ( fraction * (double) histogram->samples );
+
+    uint64_t seen = 0;
+
+    unsigned int i;
+
+    for ( i = 0; i < (stats->bucket_count - 1); i++ )
+    {
+        seen += histogram->counts[i];
+
+        if ( seen > target )
+        {
+            return ( stats->bounds_ns[i] < histogram->max_ns ) ? stats->bounds_ns[i] : histogram->max_ns;
+        }
+    }
+
+    return histogram->max_ns;
+}
+
+static oscc_result_t bench_run(
+    const bench_options_s * const options,
+    bool realtime )
+{
+    oscc_context_t * context = NULL;
+
+    int sockets[2] = { -1, -1 };
+
+    oscc_result_t result = oscc_context_create( &context );
+
+    if ( result == OSCC_OK )
+    {
+        result = oscc_context_set_receive_mode( context, OSCC_RECEIVE_MODE_THREAD );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        // Both runs share the loaded core, only the scheduling differs
+        result = realtime
+            ? oscc_context_set_receive_realtime( context, options->priority, options->cpu, true )
+            : oscc_context_set_receive_realtime( context, 0, options->cpu, false );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        result = oscc_context_subscribe_to_can_id( context, BENCH_CAN_ID, bench_handler, NULL );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        const int enable = 1;
+
+        // The kernel timestamps each frame as it is sent, which is what the
+        // receive to callback histogram measures from
+        if ( (socketpair( AF_UNIX, SOCK_DGRAM, 0, sockets ) < 0)
+            || (setsockopt( sockets[0], SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable) ) < 0) )
+        {
+            perror( "Creating bench sockets failed:" );
+
+            result = OSCC_ERROR;
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        context->oscc_can_socket = sockets[0];
+
+        result = oscc_start_receiving( context );
+
+        if ( result != OSCC_OK )
+        {
+            printf( "Error: could not start the receive threads%s\n",
+                    realtime ? ", real-time scheduling and mlockall need privileges" : "" );
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        const struct timespec interval =
+        {
+            .tv_sec = options->interval_us / 1000000,
+            .tv_nsec = ( options->interval_us % 1000000 ) * 1000
+        };
+
+        struct can_frame frame;
+
+        memset( &frame, 0, sizeof(frame) );
+        frame.can_id = BENCH_CAN_ID;
+        frame.can_dlc = CAN_MAX_DLEN;
+
+        unsigned int i;
+
+        for ( i = 0; i < options->frames; i++ )
+        {
+            (void) send( sockets[1], &frame, sizeof(frame), 0 );
+
+            nanosleep( &interval, NULL );
+        }
+
+        // Lets the last frames through before reading the histogram
+        const struct timespec settle = { .tv_sec = 0, .tv_nsec = 100000000 };
+
+        nanosleep( &settle, NULL );
+
+        oscc_stats_s stats;
+
+        result = oscc_context_get_stats( context, &stats );
+
+        if ( result == OSCC_OK )
+        {
+            const oscc_histogram_s * const latency = &stats.histograms[OSCC_STATS_RECEIVE_TO_CALLBACK];
+            const oscc_histogram_s * const dispatch = &stats.histograms[OSCC_STATS_DISPATCH];
+
+            printf( "realtime %-3s  samples %-8llu"
+                    "  receive to callback p50 <= %llu us, p99 <= %llu us, p99.9 <= %llu us, max %llu us"
+                    "  dispatch p99 <= %llu us\n",
+                    realtime ? "on" : "off",
+                    (unsigned long long) latency->samples,
+                    (unsigned long long) bench_percentile( &stats, latency, 0.5 ) / 1000,
+                    (unsigned long long) bench_percentile( &stats, latency, 0.99 ) / 1000,
+                    (unsigned long long) bench_percentile( &stats, latency, 0.999 ) / 1000,
+                    (unsigned long long) latency->max_ns / 1000,
+                    (unsigned long long) bench_percentile( &stats, dispatch, 0.99 ) / 1000 );
+        }
+        else
+        {
+            printf( "Error: no statistics, configure with -DOSCC_STATS=ON\n" );
+        }
+
+        (void) oscc_receive_thread_stop( context );
+    }
+
+    if ( context != NULL )
+    {
+        // The socket pair is the bench's to close
+        context->oscc_can_socket = UNINITIALIZED_SOCKET;
+
+        oscc_context_destroy( context );
+    }
+
+    if ( sockets[0] >= 0 )
+    {
+        close( sockets[0] );
+        close( sockets[1] );
+    }
+
+    return result;
+}
+
+static void bench_usage( const char * program )
+{
+    printf( "Usage: %s [-n frames] [-i interval_us] [-l load_threads] [-p priority] [-c cpu]\n", program );
+}
+
+int main( int argc, char ** argv )
+{
+    bench_options_s options =
+    {
+        .frames = 5000,
+        .interval_us = 200,
+        .load_threads = 8,
+        .priority = BENCH_PRIORITY_DEFAULT,
+        .cpu = 0
+    };
+
+    int option;
+
+    while ( (option = getopt( argc, argv, "n:i:l:p:c:h" )) != -1 )
+    {
+        switch ( option )
+        {
+            case 'n':
+                options.frames = (unsigned int) strtoul( optarg, NULL, 10 );
+                break;
+
+            case 'i':
+                options.interval_us = (unsigned int) strtoul( optarg, NULL, 10 );
+                break;
+
+            case 'l':
+                options.load_threads = (unsigned int) strtoul( optarg, NULL, 10 );
+                break;
+
+            case 'p':
+                options.priority = (int) strtol( optarg, NULL, 10 );
+                break;
+
+            case 'c':
+                options.cpu = (int) strtol( optarg, NULL, 10 );
+                break;
+
+            default:
+                bench_usage( argv[0] );
+
+                return ( option == 'h' ) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    pthread_t * const load_threads = calloc( options.load_threads, sizeof(pthread_t) );
+
+    pthread_attr_t attr;
+    cpu_set_t cpus;
+
+    CPU_ZERO( &cpus );
+    CPU_SET( options.cpu, &cpus );
+
+    pthread_attr_init( &attr );
+    pthread_attr_setaffinity_np( &attr, sizeof(cpus), &cpus );
+
+    unsigned int started;
+
+    for ( started = 0; (load_threads != NULL) && (started < options.load_threads); started++ )
+    {
+        if ( pthread_create( &load_threads[started], &attr, bench_load_thread, NULL ) != 0 )
+        {
+            break;
+        }
+    }
+
+    pthread_attr_destroy( &attr );
+
+    printf( "%u frames every %u us, %u busy threads on core %d\n",
+            options.frames, options.interval_us, started, options.cpu );
+
+    const oscc_result_t normal = bench_run( &options, false );
+    const oscc_result_t realtime = bench_run( &options, true );
+
+    atomic_store( &global_loading, false );
+
+    unsigned int i;
+
+    for ( i = 0; i < started; i++ )
+    {
+        pthread_join( load_threads[i], NULL );
+    }
+
+    free( load_threads );
+
+    return ( (normal == OSCC_OK) && (realtime == OSCC_OK) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
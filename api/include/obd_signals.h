@@ -0,0 +1,51 @@
+/**
+ * @file obd_signals.h
+ * @brief Vehicles and OBD signals the API can decode at runtime.
+ *
+ */
+
+
+#ifndef _OSCC_OBD_SIGNALS_H_
+#define _OSCC_OBD_SIGNALS_H_
+
+
+/**
+ * @brief Vehicles whose OBD signals can be decoded, see \ref oscc_set_vehicle.
+ *
+ */
+typedef enum
+{
+    OSCC_VEHICLE_KIA_SOUL,
+    OSCC_VEHICLE_KIA_SOUL_EV,
+    OSCC_VEHICLE_KIA_NIRO,
+    OSCC_VEHICLE_COUNT
+} oscc_vehicle_t;
+
+
+/**
+ * @brief OBD signals decoded by \ref oscc_decode_obd_frame, used as indices
+ *        into its array of values.
+ *
+ */
+typedef enum
+{
+    OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT, /* kph */
+    OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_FRONT, /* kph */
+    OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_REAR, /* kph */
+    OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_REAR, /* kph */
+    OSCC_OBD_SIGNAL_STEERING_WHEEL_ANGLE, /* degrees */
+    OSCC_OBD_SIGNAL_BRAKE_PRESSURE, /* bar */
+    OSCC_OBD_SIGNAL_COUNT
+} oscc_obd_signal_t;
+
+
+/*
+ * @brief OSCC_WHEEL_SPEED_COUNT is the number of wheel speeds
+ * \ref oscc_decode_wheel_speeds returns per frame, ordered as the
+ * OSCC_OBD_SIGNAL_WHEEL_SPEED signals are.
+ *
+ */
+#define OSCC_WHEEL_SPEED_COUNT ( 4 )
+
+
+#endif /* _OSCC_OBD_SIGNALS_H_ */
@@ -10,20 +10,24 @@
 
 
 #include <linux/can.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
 
 #include "can_protocols/brake_can_protocol.h"
 #include "can_protocols/fault_can_protocol.h"
 #include "can_protocols/steering_can_protocol.h"
 #include "can_protocols/throttle_can_protocol.h"
+#include "obd_signals.h"
 #include "vehicles.h"
 
 
 /*
- * @brief MAX_CAN_IDS is the maximum number unique CAN IDs on the CAN bus used
- * for auto detection of CAN channels. Increasing this number increases the wait
- * time for checking if a channel contains expected CAN IDs, reducing this
- * number below number of CAN IDs broadcast could yield a false negative in auto
- * detection.
+ * @brief MAX_CAN_IDS is the maximum number of frames read from a CAN channel
+ * during auto detection of CAN channels. A channel stops being probed as soon
+ * as every expected CAN ID has been seen, so this only bounds channels that
+ * never show all of them.
  *
  */
 #define MAX_CAN_IDS ( 70 )
@@ -31,12 +35,96 @@
 
 /*
  * @brief CAN_MESSAGE_TIMEOUT is the time to wait for a CAN message in
- * milliseconds used for auto detection of can channels.
+ * milliseconds used for auto detection of can channels. A channel that stays
+ * quiet this long is done being probed.
  *
  */
 #define CAN_MESSAGE_TIMEOUT ( 100 )
 
 
+/*
+ * @brief CAN_DETECTION_TIMEOUT is the time in milliseconds that auto
+ * detection of CAN channels may take in total. Every channel is probed at
+ * the same time, so this does not grow with the number of channels.
+ *
+ */
+#define CAN_DETECTION_TIMEOUT ( 500 )
+
+
+/*
+ * @brief OSCC_RECEIVE_BATCH_SIZE_MAX is the largest number of CAN frames that
+ * can be read from a socket with a single system call.
+ *
+ */
+#define OSCC_RECEIVE_BATCH_SIZE_MAX ( 64 )
+
+
+/*
+ * @brief OSCC_RECEIVE_BATCH_SIZE_DEFAULT is the number of CAN frames read from
+ * a socket with a single system call unless changed with
+ * \ref oscc_set_receive_batch_size.
+ *
+ */
+#define OSCC_RECEIVE_BATCH_SIZE_DEFAULT ( 32 )
+
+
+/*
+ * @brief OSCC_OBD_FILTER_SIZE_MAX is the largest number of OBD CAN IDs that can
+ * be passed to \ref oscc_set_obd_message_filter.
+ *
+ */
+#define OSCC_OBD_FILTER_SIZE_MAX ( 64 )
+
+
+/*
+ * @brief OSCC_FD_COUNT_MAX is the largest number of file descriptors
+ * \ref oscc_get_fds can return.
+ *
+ */
+#define OSCC_FD_COUNT_MAX ( 2 )
+
+
+/*
+ * @brief OSCC_CONTEXT_COUNT_MAX is the largest number of contexts that can
+ * exist at once, including the default context.
+ *
+ */
+#define OSCC_CONTEXT_COUNT_MAX ( 16 )
+
+
+/*
+ * @brief OSCC_TRANSMIT_RATE_MAX is the highest rate in Hz that
+ * \ref oscc_set_transmit_rate accepts.
+ *
+ */
+#define OSCC_TRANSMIT_RATE_MAX ( 1000 )
+
+
+/*
+ * @brief OSCC_BUSY_POLL_SPIN_BUDGET_DEFAULT is the number of empty polls after
+ * which the \ref OSCC_RECEIVE_MODE_BUSY_POLL thread backs off by default.
+ *
+ */
+#define OSCC_BUSY_POLL_SPIN_BUDGET_DEFAULT ( 1000 )
+
+
+/*
+ * @brief OSCC_STATS_BUCKET_COUNT is the number of buckets in each histogram
+ * returned by \ref oscc_get_stats, one more than the most bounds
+ * \ref oscc_set_stats_bounds accepts.
+ *
+ */
+#define OSCC_STATS_BUCKET_COUNT ( 32 )
+
+
+/*
+ * @brief OSCC_CAN_BITRATE is the bit rate in bits per second of both CAN
+ * buses, used to estimate their load in \ref oscc_get_bus_stats.
+ *
+ */
+#define OSCC_CAN_BITRATE ( 500000 )
+
+
 typedef enum
 {
     OSCC_OK,
@@ -44,166 +132,1947 @@ typedef enum
     OSCC_WARNING
 } oscc_result_t;
 
-/**
- * @brief Looks for available CAN channels and automatically detects which
- *        channel is OSCC control and which channel is vehicle CAN for feedback.
+
+/*
+ * @brief How frames received from the CAN sockets reach the registered
+ *        callbacks.
  *
- * @return OSCC_ERROR or OSCC_OK
+ * OSCC_RECEIVE_MODE_SIGNAL - Callbacks run inside a SIGIO handler on whichever
+ *                            thread the signal interrupts. (default)
  *
- */
-oscc_result_t oscc_init();
-
-/**
- * @brief Use provided CAN channel to open communications to CAN bus connected
- *        to the OSCC modules. If CAN gateway does not forward Vehicle CAN
- *        automatically detect if a CAN channel has Vehicle CAN available.
+ * OSCC_RECEIVE_MODE_THREAD - A dedicated receive thread waits on both sockets
+ *                            with epoll and hands frames through a lock-free
+ *                            queue to a dispatch thread that runs the
+ *                            callbacks. No signals are used.
  *
- * @param [in] channel - CAN channel connected to OSCC modules.
+ * OSCC_RECEIVE_MODE_EXTERNAL - No signals or threads are used. The caller's
+ *                              event loop waits on the descriptors from
+ *                              \ref oscc_get_fds and calls
+ *                              \ref oscc_process_pending when they are
+ *                              readable, which runs the callbacks on the
+ *                              caller's thread.
  *
- * @return OSCC_ERROR or OSCC_OK
+ * OSCC_RECEIVE_MODE_BUSY_POLL - A dedicated thread polls both sockets without
+ *                               blocking and runs the callbacks itself, see
+ *                               \ref oscc_set_busy_poll. Meant for a core
+ *                               given over to CAN I/O.
  *
  */
-oscc_result_t oscc_open( unsigned int channel );
+typedef enum
+{
+    OSCC_RECEIVE_MODE_SIGNAL,
+    OSCC_RECEIVE_MODE_THREAD,
+    OSCC_RECEIVE_MODE_EXTERNAL,
+    OSCC_RECEIVE_MODE_BUSY_POLL
+} oscc_receive_mode_t;
 
 
-/**
- * @brief Use provided CAN channel to close communications
- *        to CAN bus connected to the OSCC modules.
+/*
+ * @brief System calls the threads of \ref OSCC_RECEIVE_MODE_THREAD use to
+ *        receive frames and write commands, see \ref oscc_set_io_backend.
  *
- * @param [in] channel - CAN channel connected to OSCC modules.
+ * OSCC_IO_BACKEND_EPOLL - Wait with epoll, read with recvmmsg and write with
+ *                         sendmmsg. (default)
  *
- * @return OSCC_ERROR or OSCC_OK
+ * OSCC_IO_BACKEND_IO_URING - Keep multishot receives into kernel-selected
+ *                            buffers outstanding on an io_uring, so frames
+ *                            arrive without a read call each, and write
+ *                            commands as linked submissions.
  *
  */
-oscc_result_t oscc_close( unsigned int channel );
+typedef enum
+{
+    OSCC_IO_BACKEND_EPOLL,
+    OSCC_IO_BACKEND_IO_URING
+} oscc_io_backend_t;
 
 
-/**
- * @brief Send enable commands to all OSCC modules.
+/*
+ * @brief What the \ref OSCC_RECEIVE_MODE_BUSY_POLL thread does after polling
+ *        both sockets spin_budget times in a row without receiving a frame.
+ *        It goes back to spinning as soon as a frame arrives.
  *
- * @param [void]
+ * OSCC_BUSY_POLL_BACKOFF_NONE - Keep spinning. (default)
  *
- * @return OSCC_ERROR or OSCC_OK
+ * OSCC_BUSY_POLL_BACKOFF_YIELD - Yield the core to any other runnable thread
+ *                                before each poll.
+ *
+ * OSCC_BUSY_POLL_BACKOFF_SLEEP - Sleep for backoff_ns before each poll.
  *
  */
-oscc_result_t oscc_enable( void );
+typedef enum
+{
+    OSCC_BUSY_POLL_BACKOFF_NONE,
+    OSCC_BUSY_POLL_BACKOFF_YIELD,
+    OSCC_BUSY_POLL_BACKOFF_SLEEP
+} oscc_busy_poll_backoff_t;
 
 
-/**
- * @brief Send disable commands to all OSCC modules.
+/*
+ * @brief Settings of the \ref OSCC_RECEIVE_MODE_BUSY_POLL thread, see
+ *        \ref oscc_set_busy_poll.
  *
- * @param [void]
+ */
+typedef struct
+{
+    unsigned int spin_budget; /* Empty polls before backing off, zero to back off straight away. */
+
+    oscc_busy_poll_backoff_t backoff; /* One of \ref oscc_busy_poll_backoff_t. */
+
+    unsigned int backoff_ns; /* Sleep of OSCC_BUSY_POLL_BACKOFF_SLEEP, below one second. */
+
+    unsigned int socket_busy_poll_us; /* SO_BUSY_POLL of both sockets, zero leaves it unset. */
+} oscc_busy_poll_s;
+
+
+/*
+ * @brief CAN buses a context receives from. When OSCC and vehicle CAN share a
+ *        channel every frame is counted against OSCC_CAN_BUS_OSCC.
  *
- * @return OSCC_ERROR or OSCC_OK
+ */
+typedef enum
+{
+    OSCC_CAN_BUS_OSCC,
+    OSCC_CAN_BUS_VEHICLE,
+    OSCC_CAN_BUS_COUNT
+} oscc_can_bus_t;
+
+
+/*
+ * @brief Periodic report streams of the modules, watched by the report
+ *        watchdog, see \ref oscc_set_report_watchdog, and used to index
+ *        \ref oscc_confirmation_s.
  *
  */
-oscc_result_t oscc_disable( void );
+typedef enum
+{
+    OSCC_REPORT_STREAM_BRAKE,
+    OSCC_REPORT_STREAM_THROTTLE,
+    OSCC_REPORT_STREAM_STEERING,
+    OSCC_REPORT_STREAM_COUNT
+} oscc_report_stream_t;
 
 
-/**
- * @brief Publish message with requested brake pedal position to
- *        brake module.
+/*
+ * @brief Set of commands to publish together with \ref oscc_publish_commands.
+ *        Only the commands whose publish flag is true are sent.
  *
- * @param [in] position - Normalized requested brake pedal
- *        position in the range [0, 1].
+ */
+typedef struct
+{
+    bool publish_brake; /* Send brake_position to the brake module. */
+
+    double brake_position; /* Normalized brake pedal position [0, 1]. */
+
+    bool publish_throttle; /* Send throttle_position to the throttle module. */
+
+    double throttle_position; /* Normalized throttle pedal position [0, 1]. */
+
+    bool publish_steering; /* Send steering_torque to the steering module. */
+
+    double steering_torque; /* Normalized steering wheel torque [-1, 1]. */
+} oscc_command_set_s;
+
+
+/*
+ * @brief One OSCC stack: the CAN sockets to a set of OSCC modules and their
+ *        vehicle, the callbacks subscribed to them and the receive machinery
+ *        delivering their frames. Contexts share nothing, so a process can
+ *        drive several vehicles at once, each from its own threads.
  *
- * @return OSCC_ERROR or OSCC_OK
+ * Every function not taking a context acts on the one returned by
+ * \ref oscc_default_context.
  *
  */
-oscc_result_t oscc_publish_brake_position( double brake_position );
+typedef struct oscc_context_s oscc_context_t;
 
 
-/**
- * @brief Publish message with requested throttle pedal position to
- *        throttle module.
+/*
+ * @brief Handler for every frame with one CAN ID, see
+ *        \ref oscc_subscribe_to_can_id.
  *
- * @param [in] position - Normalized requested throttle pedal
- *        position in the range [0, 1].
+ * @param [in] frame - The received frame.
  *
- * @return OSCC_ERROR or OSCC_OK
+ * @param [in] timestamp - Receive time of the frame, taken as for the
+ *                         timestamped callbacks.
+ *
+ * @param [in] user_data - Pointer given when the handler was registered.
  *
  */
-oscc_result_t oscc_publish_throttle_position( double throttle_position );
+typedef void (*oscc_can_id_handler_t)(
+    const struct can_frame *frame,
+    const struct timespec *timestamp,
+    void *user_data );
 
 
-/**
- * @brief Publish message with requested steering torque to
- *        steering module.
- *
- * @param [in] angle - Normalized requested steering wheel
- *        torque in the range [-1, 1].
+/*
+ * @brief Counters of the system calls made to read from the CAN sockets.
  *
- * @return OSCC_ERROR or OSCC_OK
+ */
+typedef struct
+{
+    uint64_t syscalls; /* Number of recvmmsg, or io_uring_enter, calls made. */
+
+    uint64_t frames; /* Number of frames those calls returned. */
+
+    double frames_per_syscall; /* Average frames returned by each call. */
+} oscc_receive_counters_s;
+
+
+/*
+ * @brief Time taken by enable and disable requests, from the call until the
+ *        bus confirmed their last frame, see \ref oscc_get_priority_latency.
  *
  */
-oscc_result_t oscc_publish_steering_torque( double torque );
+typedef struct
+{
+    uint64_t last_ns; /* Latency of the latest request measured. */
 
+    uint64_t worst_ns; /* Highest latency measured. */
 
-/**
- * @brief Register callback function to be called when brake report
- *        received from brake module.
+    uint64_t requests; /* Number of requests measured. */
+} oscc_priority_latency_s;
+
+
+/*
+ * @brief Outcome of \ref oscc_enable_confirmed and
+ *        \ref oscc_disable_confirmed for each module, indexed by
+ *        \ref oscc_report_stream_t.
  *
- * @param [in] callback - Pointer to callback function to be called when
- *                        brake report received from brake module.
+ */
+typedef struct
+{
+    bool confirmed[OSCC_REPORT_STREAM_COUNT]; /* Whether a report showed the
+                                                 requested state in time. */
+
+    uint64_t latency_ns[OSCC_REPORT_STREAM_COUNT]; /* Time from sending the
+                                                      frames until the first
+                                                      such report was decoded,
+                                                      0 if none was. */
+} oscc_confirmation_s;
+
+
+/*
+ * @brief Traffic received with one CAN ID, see \ref oscc_get_can_id_counters.
  *
- * @return OSCC_ERROR or OSCC_OK
+ */
+typedef struct
+{
+    uint64_t frames; /* Frames received. */
+
+    uint64_t bytes; /* Payload bytes of those frames. */
+
+    uint64_t drops; /* Frames nothing decoded or handled, or that arrived
+                       while the receive queue was full. */
+
+    struct timespec last_seen; /* Receive timestamp of the latest frame, zero
+                                  if none has been seen. */
+} oscc_can_id_counters_s;
+
+
+/*
+ * @brief Traffic received from one CAN bus, see \ref oscc_get_bus_stats.
  *
  */
-oscc_result_t oscc_subscribe_to_brake_reports( void( *callback )( oscc_brake_report_s *report ) );
+typedef struct
+{
+    uint64_t frames; /* Frames received. */
 
+    uint64_t bytes; /* Payload bytes of those frames. */
 
-/**
- * @brief Register callback function to be called when throttle report
- *        received from throttle module.
+    uint64_t drops; /* Frames dropped after they were received. */
+
+    uint64_t bits; /* Estimated bits those frames took on the bus. */
+
+    double load; /* Share of \ref OSCC_CAN_BITRATE used by every frame on
+                    the bus in the latest complete second, from 0 to 1. */
+
+    uint64_t overflows; /* Frames the kernel discarded because the socket's
+                           receive queue was full. */
+} oscc_bus_stats_s;
+
+
+/*
+ * @brief Histograms kept when the library is built with OSCC_STATS, used as
+ *        indices into \ref oscc_stats_s.
  *
- * @param [in] callback - Pointer to callback function to be called when
- *                        throttle report received from throttle module.
+ * OSCC_STATS_*_REPORT_INTERVAL - Time between consecutive reports of a module,
+ *                                taken from the frames' receive timestamps.
  *
- * @return OSCC_ERROR or OSCC_OK
+ * OSCC_STATS_*_COMMAND_TO_REPORT - Time from publishing a command to a module
+ *                                  until its next report is decoded.
+ *
+ * OSCC_STATS_RECEIVE_TO_CALLBACK - Time from a frame's receive timestamp
+ *                                  until its callbacks start running, which
+ *                                  compares the receive modes.
+ *
+ * OSCC_STATS_DISPATCH - Time taken to decode a received frame and run the
+ *                       callbacks registered for it.
+ *
+ * OSCC_STATS_WRITE - Time spent in each system call writing to a CAN socket.
  *
  */
-oscc_result_t oscc_subscribe_to_throttle_reports( void( *callback )( oscc_throttle_report_s *report ) );
+typedef enum
+{
+    OSCC_STATS_BRAKE_REPORT_INTERVAL,
+    OSCC_STATS_STEERING_REPORT_INTERVAL,
+    OSCC_STATS_THROTTLE_REPORT_INTERVAL,
+    OSCC_STATS_FAULT_REPORT_INTERVAL,
+    OSCC_STATS_BRAKE_COMMAND_TO_REPORT,
+    OSCC_STATS_THROTTLE_COMMAND_TO_REPORT,
+    OSCC_STATS_STEERING_COMMAND_TO_REPORT,
+    OSCC_STATS_RECEIVE_TO_CALLBACK,
+    OSCC_STATS_DISPATCH,
+    OSCC_STATS_WRITE,
+    OSCC_STATS_HISTOGRAM_COUNT
+} oscc_stats_histogram_t;
 
 
-/**
- * @brief Register callback function to be called when steering report
- *        received from steering module.
- *
- * @param [in] callback - Pointer to callback function to be called when
- *                        steering report received from steering module.
- *
- * @return OSCC_ERROR or OSCC_OK
+/*
+ * @brief Samples of one histogram, see \ref oscc_get_stats. Bucket i counts
+ *        the samples above bound i - 1 up to and including bound i, and the
+ *        last bucket in use counts every sample above the highest bound.
  *
  */
-oscc_result_t oscc_subscribe_to_steering_reports( void( *callback )( oscc_steering_report_s *report ) );
+typedef struct
+{
+    uint64_t counts[OSCC_STATS_BUCKET_COUNT]; /* Samples in each bucket. */
 
+    uint64_t samples; /* Number of samples recorded. */
 
-/**
- * @brief Register callback function to be called when fault report
- *        received from any module.
+    uint64_t total_ns; /* Sum of the samples. */
+
+    uint64_t min_ns; /* Smallest sample, 0 if there are none. */
+
+    uint64_t max_ns; /* Largest sample. */
+} oscc_histogram_s;
+
+
+/*
+ * @brief Latency histograms of a context, see \ref oscc_get_stats.
  *
- * @param [in] callback - Pointer to callback function to be called when
- *                        fault report received from any module.
+ */
+typedef struct
+{
+    uint64_t bounds_ns[OSCC_STATS_BUCKET_COUNT - 1]; /* Upper bound of each bucket. */
+
+    unsigned int bucket_count; /* Buckets in use, one more than the bounds. */
+
+    oscc_histogram_s histograms[OSCC_STATS_HISTOGRAM_COUNT];
+} oscc_stats_s;
+
+
+/*
+ * @brief Most recent brake report, see \ref oscc_get_latest_brake_report.
  *
- * @return OSCC_ERROR or OSCC_OK
+ */
+typedef struct
+{
+    oscc_brake_report_s report; /* Latest report received. */
+
+    struct timespec timestamp; /* Receive time of the report, taken as for the
+                                  timestamped callbacks. */
+
+    uint64_t sequence; /* Number of brake reports received, zero if none. */
+} oscc_brake_report_snapshot_s;
+
+
+/*
+ * @brief Most recent steering report, see
+ *        \ref oscc_get_latest_steering_report.
  *
  */
-oscc_result_t oscc_subscribe_to_fault_reports( void( *callback )( oscc_fault_report_s *report ) );
+typedef struct
+{
+    oscc_steering_report_s report; /* Latest report received. */
 
+    struct timespec timestamp; /* Receive time of the report, taken as for the
+                                  timestamped callbacks. */
 
-/**
- * @brief Register callback function to be called when OBD message received
- *        from vehicle.
+    uint64_t sequence; /* Number of steering reports received, zero if none. */
+} oscc_steering_report_snapshot_s;
+
+
+/*
+ * @brief Most recent throttle report, see
+ *        \ref oscc_get_latest_throttle_report.
  *
- * @param [in] callback - Pointer to callback function to be called when
- *                        OBD message received.
+ */
+typedef struct
+{
+    oscc_throttle_report_s report; /* Latest report received. */
+
+    struct timespec timestamp; /* Receive time of the report, taken as for the
+                                  timestamped callbacks. */
+
+    uint64_t sequence; /* Number of throttle reports received, zero if none. */
+} oscc_throttle_report_snapshot_s;
+
+
+/*
+ * @brief Most recent fault report, see \ref oscc_get_latest_fault_report.
  *
- * @return OSCC_ERROR or OSCC_OK
+ */
+typedef struct
+{
+    oscc_fault_report_s report; /* Latest report received. */
+
+    struct timespec timestamp; /* Receive time of the report, taken as for the
+                                  timestamped callbacks. */
+
+    uint64_t sequence; /* Number of fault reports received, zero if none. */
+} oscc_fault_report_snapshot_s;
+
+
+/*
+ * @brief Most recent values decoded from vehicle OBD messages, see
+ *        \ref oscc_get_latest_obd_values. Each group of values carries the
+ *        receive time of the message it was decoded from, which is zero until
+ *        that message has been received.
+ *
+ */
+typedef struct
+{
+    double wheel_speed_left_front; /* Wheel speeds (kph). */
+
+    double wheel_speed_right_front;
+
+    double wheel_speed_left_rear;
+
+    double wheel_speed_right_rear;
+
+    struct timespec wheel_speed_timestamp;
+
+    double steering_wheel_angle; /* Steering wheel angle (degrees). */
+
+    struct timespec steering_wheel_angle_timestamp;
+
+    double brake_pressure; /* Brake pressure (bar). */
+
+    struct timespec brake_pressure_timestamp;
+
+    uint64_t sequence; /* Number of OBD messages decoded, zero if none. */
+} oscc_obd_snapshot_s;
+
+
+/**
+ * @brief Select how received frames are delivered to callbacks. Must be
+ *        called before \ref oscc_init or \ref oscc_open.
+ *
+ * @param [in] mode - One of \ref oscc_receive_mode_t.
+ *
+ * @return OSCC_ERROR if communications are already open, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_receive_mode( oscc_receive_mode_t mode );
+
+
+/**
+ * @brief Get the threads created by \ref OSCC_RECEIVE_MODE_THREAD so they can
+ *        be pinned to cores or given a scheduling policy. With
+ *        \ref OSCC_RECEIVE_MODE_BUSY_POLL both are the polling thread.
+ *
+ * @param [out] receive_thread - Thread reading frames from the CAN sockets.
+ *
+ * @param [out] dispatch_thread - Thread running the registered callbacks.
+ *
+ * @return OSCC_ERROR if the receive threads are not running, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_receive_threads(
+    pthread_t * receive_thread,
+    pthread_t * dispatch_thread );
+
+
+/**
+ * @brief Run the threads of \ref OSCC_RECEIVE_MODE_THREAD, or the thread of
+ *        \ref OSCC_RECEIVE_MODE_BUSY_POLL, as real-time threads, so dispatching a report neither page faults nor waits
+ *        behind best-effort threads. Must be called before \ref oscc_init
+ *        or \ref oscc_open, which fail if the process lacks the privileges
+ *        asked for (CAP_SYS_NICE or RLIMIT_RTPRIO for a priority,
+ *        CAP_IPC_LOCK or RLIMIT_MEMLOCK to lock memory).
+ *
+ * @param [in] priority - SCHED_FIFO priority of both threads, or zero to
+ *                        leave them under the default policy.
+ *
+ * @param [in] cpu - Core both threads are pinned to, or -1 to let them run
+ *                   on any core.
+ *
+ * @param [in] lock_memory - Lock every current and future page of the
+ *                           process into memory. The lock applies to the
+ *                           whole process and is kept after \ref oscc_close.
+ *
+ * @return OSCC_ERROR if priority is outside the SCHED_FIFO range, cpu is
+ *         not a valid core number or communications are already open,
+ *         otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_receive_realtime(
+    int priority,
+    int cpu,
+    bool lock_memory );
+
+
+/**
+ * @brief Select the system calls \ref OSCC_RECEIVE_MODE_THREAD uses to read
+ *        and write its sockets. Must be called before \ref oscc_init or
+ *        \ref oscc_open. Where the kernel lacks what
+ *        \ref OSCC_IO_BACKEND_IO_URING needs (Linux 6.0) or io_uring is
+ *        disabled, opening falls back to \ref OSCC_IO_BACKEND_EPOLL, see
+ *        \ref oscc_get_io_backend.
+ *
+ * @param [in] backend - One of \ref oscc_io_backend_t.
+ *
+ * @return OSCC_ERROR if backend is invalid or communications are already
+ *         open, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_io_backend( oscc_io_backend_t backend );
+
+
+/**
+ * @brief Get the backend the threads of \ref OSCC_RECEIVE_MODE_THREAD
+ *        ended up using.
+ *
+ * @param [out] backend - Backend in use.
+ *
+ * @return OSCC_ERROR if backend is NULL or the receive threads are not
+ *         running, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_io_backend( oscc_io_backend_t * backend );
+
+
+/**
+ * @brief Configure the polling thread of \ref OSCC_RECEIVE_MODE_BUSY_POLL.
+ *        Must be called before \ref oscc_init or \ref oscc_open. A spinning
+ *        thread with a real-time priority, see
+ *        \ref oscc_set_receive_realtime, takes its core entirely unless it
+ *        backs off by sleeping, so only pin it to a core kept free of other
+ *        work.
+ *
+ * @param [in] busy_poll - Settings to use, copied before returning.
+ *
+ * @return OSCC_ERROR if busy_poll is NULL or invalid, or communications are
+ *         already open, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_busy_poll( const oscc_busy_poll_s * busy_poll );
+
+
+/**
+ * @brief Get the file descriptors an external event loop should wait on for
+ *        readability when using \ref OSCC_RECEIVE_MODE_EXTERNAL. They are
+ *        valid from a successful \ref oscc_init or \ref oscc_open until
+ *        \ref oscc_close.
+ *
+ * @param [out] fds - Array to fill with descriptors, with room for at least
+ *                    \ref OSCC_FD_COUNT_MAX entries.
+ *
+ * @param [in,out] count - Number of entries fds can hold on input, number of
+ *                         descriptors written on output.
+ *
+ * @return OSCC_ERROR if a parameter is NULL, fds is too small or no CAN
+ *         socket is open, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_fds( int * fds, unsigned int * count );
+
+
+/**
+ * @brief Read every frame waiting on the CAN sockets, up to a limit, and run
+ *        the registered callbacks for them on the calling thread. Never
+ *        blocks. Only valid with \ref OSCC_RECEIVE_MODE_EXTERNAL.
+ *
+ * @param [in] max_frames - Largest number of frames to process, or zero for
+ *                          no limit. Frames left over keep the descriptors
+ *                          readable.
+ *
+ * @param [out] frames_processed - Number of frames processed. May be NULL.
+ *
+ * @return OSCC_ERROR if not in \ref OSCC_RECEIVE_MODE_EXTERNAL, otherwise
+ *         OSCC_OK
+ *
+ */
+oscc_result_t oscc_process_pending(
+    unsigned int max_frames,
+    unsigned int * frames_processed );
+
+
+/**
+ * @brief Set how many CAN frames are read from a socket with each system call.
+ *
+ * @param [in] size - Frames per call in the range
+ *                    [1, \ref OSCC_RECEIVE_BATCH_SIZE_MAX].
+ *
+ * @return OSCC_ERROR if size is out of range, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_receive_batch_size( unsigned int size );
+
+
+/**
+ * @brief Get the number of receive system calls made and frames read by them
+ *        since the library was loaded.
+ *
+ * @param [out] counters - Pointer to \ref oscc_receive_counters_s to fill.
+ *
+ * @return OSCC_ERROR if counters is NULL, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_receive_counters( oscc_receive_counters_s * counters );
+
+
+/**
+ * @brief Get the traffic received with one CAN ID since the context was
+ *        created. Every frame the sockets receive is counted, including
+ *        frames no callback was registered for.
+ *
+ * @param [in] bus - Bus the frames were received from.
+ *
+ * @param [in] can_id - Standard CAN ID, or CAN_EFF_FLAG for the combined
+ *                      count of every extended frame.
+ *
+ * @param [out] counters - Pointer to \ref oscc_can_id_counters_s to fill.
+ *
+ * @return OSCC_ERROR if bus or can_id is invalid or counters is NULL,
+ *         otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_can_id_counters(
+    oscc_can_bus_t bus,
+    canid_t can_id,
+    oscc_can_id_counters_s * counters );
+
+
+/**
+ * @brief Get the traffic received from a CAN bus and its estimated load.
+ *        The frames, bytes and bits are those the sockets received, which
+ *        the filters limit to the frames something is registered for. The
+ *        load is taken from the interface's own counters, which include
+ *        every frame on the bus, assuming standard IDs and worst-case bit
+ *        stuffing. Where the interface cannot be read, as during a replay,
+ *        the load only covers the frames the sockets received.
+ *
+ * @param [in] bus - Bus to get the traffic of.
+ *
+ * @param [out] stats - Pointer to \ref oscc_bus_stats_s to fill.
+ *
+ * @return OSCC_ERROR if bus is invalid or stats is NULL, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_bus_stats(
+    oscc_can_bus_t bus,
+    oscc_bus_stats_s * stats );
+
+
+/**
+ * @brief Append every frame received from now on, from both sockets, to a
+ *        binary log with its receive timestamp. An existing log is appended
+ *        to. Recording stops with \ref oscc_stop_recording or when
+ *        communications are closed.
+ *
+ * @param [in] path - Path of the log to create or append to.
+ *
+ * @return OSCC_ERROR if already recording or the file cannot be opened or is
+ *         not a frame log, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_start_recording( const char * path );
+
+
+/**
+ * @brief Stop recording frames and close the log. Returns once frames being
+ *        written have reached it.
+ *
+ * @return OSCC_WARNING if not recording, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_stop_recording( void );
+
+
+/**
+ * @brief Feed a log written by \ref oscc_start_recording through the same
+ *        decoding and callbacks as frames received live, with the recorded
+ *        timestamps. Blocks on the calling thread until the whole log has
+ *        been replayed. Communications must be closed, so that replayed
+ *        frames are never mixed with live ones.
+ *
+ * @param [in] path - Path of the log to replay.
+ *
+ * @param [in] speed - 1.0 to keep the recorded timing, N to run N times
+ *                     faster, or 0 to replay as fast as possible.
+ *
+ * @return OSCC_ERROR if speed is negative, communications are open or the
+ *         file is not a frame log, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_replay( const char * path, double speed );
+
+
+/**
+ * @brief Send commands at a fixed rate instead of as they are published.
+ *        The oscc_publish functions then only replace the latest command for
+ *        each module and never block. A timer thread sends whichever commands
+ *        changed since its last tick, so however fast commands are published
+ *        the bus carries at most one per module per tick. Must be called
+ *        before \ref oscc_init or \ref oscc_open.
+ *
+ * @param [in] rate - Ticks per second in the range
+ *                    [1, \ref OSCC_TRANSMIT_RATE_MAX], or 0 to write each
+ *                    command as it is published, which is the default.
+ *
+ * @return OSCC_ERROR if rate is out of range or communications are already
+ *         open, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_transmit_rate( unsigned int rate );
+
+
+/**
+ * @brief Discard the commands published through the transmit scheduler that
+ *        have not been sent yet. \ref oscc_disable does this itself.
+ *
+ * @return OSCC_OK
+ *
+ */
+oscc_result_t oscc_flush_commands( void );
+
+
+/**
+ * @brief Get how long enable and disable requests took to reach the bus.
+ *        They are sent on a socket of their own whose frames the kernel
+ *        queues ahead of commands, and the time is taken when the CAN
+ *        interface echoes their last frame back.
+ *
+ * @param [out] latency - Pointer to \ref oscc_priority_latency_s to fill.
+ *
+ * @return OSCC_ERROR if latency is NULL, OSCC_WARNING if no request has been
+ *         measured yet, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_priority_latency( oscc_priority_latency_s * latency );
+
+
+/**
+ * @brief Get the latency histograms collected so far. They are only kept
+ *        when the library is built with OSCC_STATS, otherwise nothing is
+ *        measured and this fails.
+ *
+ * @param [out] stats - Pointer to \ref oscc_stats_s to fill.
+ *
+ * @return OSCC_ERROR if stats is NULL or the library was built without
+ *         OSCC_STATS, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_stats( oscc_stats_s * stats );
+
+
+/**
+ * @brief Clear every sample of the latency histograms.
+ *
+ * @return OSCC_ERROR if the library was built without OSCC_STATS, otherwise
+ *         OSCC_OK
+ *
+ */
+oscc_result_t oscc_reset_stats( void );
+
+
+/**
+ * @brief Replace the bucket bounds of the latency histograms, which by
+ *        default double from one microsecond. Clears every sample. Must be
+ *        called before \ref oscc_init or \ref oscc_open.
+ *
+ * @param [in] bounds_ns - Upper bound of each bucket in nanoseconds, in
+ *                         increasing order.
+ *
+ * @param [in] count - Number of bounds, at least 1 and less than
+ *                     \ref OSCC_STATS_BUCKET_COUNT.
+ *
+ * @return OSCC_ERROR if the bounds are invalid, communications are already
+ *         open or the library was built without OSCC_STATS, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_stats_bounds(
+    const uint64_t * bounds_ns,
+    unsigned int count );
+
+
+/**
+ * @brief Write the latency histograms as text, one line per histogram
+ *        followed by a line per bucket holding samples, in microseconds.
+ *
+ * @param [in] stream - Stream to write to.
+ *
+ * @return OSCC_ERROR if stream is NULL, writing failed or the library was
+ *         built without OSCC_STATS, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_print_stats( FILE * stream );
+
+
+/**
+ * @brief Looks for available CAN channels and automatically detects which
+ *        channel is OSCC control and which channel is vehicle CAN for feedback.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_init();
+
+/**
+ * @brief Use provided CAN channel to open communications to CAN bus connected
+ *        to the OSCC modules. If CAN gateway does not forward Vehicle CAN
+ *        automatically detect if a CAN channel has Vehicle CAN available.
+ *
+ * @param [in] channel - CAN channel connected to OSCC modules.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_open( unsigned int channel );
+
+
+/**
+ * @brief Use provided CAN channel to close communications
+ *        to CAN bus connected to the OSCC modules.
+ *
+ * @param [in] channel - CAN channel connected to OSCC modules.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_close( unsigned int channel );
+
+
+/**
+ * @brief Send enable commands to all OSCC modules.
+ *
+ * @param [void]
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_enable( void );
+
+
+/**
+ * @brief Send disable commands to all OSCC modules.
+ *
+ * @param [void]
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_disable( void );
+
+
+/**
+ * @brief Enable all of the modules and wait until their reports show them
+ *        enabled. The enable frames are sent together as \ref oscc_enable
+ *        sends them, then the call returns as soon as every module has
+ *        confirmed or the timeout passes. The reports are received for the
+ *        wait without subscribing to them. Only one confirmed enable or
+ *        disable can wait at a time. Not available with
+ *        \ref OSCC_RECEIVE_MODE_EXTERNAL, whose reports are only decoded by
+ *        the caller's own loop.
+ *
+ * @param [in] timeout_ms - Longest time to wait for the reports in
+ *                          milliseconds.
+ *
+ * @param [out] confirmation - Pointer to \ref oscc_confirmation_s to fill
+ *                             with the modules that confirmed and how long
+ *                             each took.
+ *
+ * @return OSCC_ERROR if confirmation is NULL, the receive mode is
+ *         \ref OSCC_RECEIVE_MODE_EXTERNAL, the frames could not be sent or
+ *         another confirmed call is waiting, OSCC_WARNING if a module did not
+ *         confirm within the timeout, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_enable_confirmed(
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation );
+
+
+/**
+ * @brief Disable all of the modules and wait until their reports show them
+ *        disabled, the same way \ref oscc_enable_confirmed waits.
+ *
+ * @param [in] timeout_ms - Longest time to wait for the reports in
+ *                          milliseconds.
+ *
+ * @param [out] confirmation - Pointer to \ref oscc_confirmation_s to fill.
+ *
+ * @return OSCC_ERROR if confirmation is NULL, the receive mode is
+ *         \ref OSCC_RECEIVE_MODE_EXTERNAL, the frames could not be sent or
+ *         another confirmed call is waiting, OSCC_WARNING if a module did not
+ *         confirm within the timeout, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_disable_confirmed(
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation );
+
+
+/**
+ * @brief Publish message with requested brake pedal position to
+ *        brake module.
+ *
+ * @param [in] position - Normalized requested brake pedal
+ *        position in the range [0, 1].
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_publish_brake_position( double brake_position );
+
+
+/**
+ * @brief Publish message with requested throttle pedal position to
+ *        throttle module.
+ *
+ * @param [in] position - Normalized requested throttle pedal
+ *        position in the range [0, 1].
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_publish_throttle_position( double throttle_position );
+
+
+/**
+ * @brief Publish message with requested steering torque to
+ *        steering module.
+ *
+ * @param [in] angle - Normalized requested steering wheel
+ *        torque in the range [-1, 1].
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_publish_steering_torque( double torque );
+
+
+/**
+ * @brief Publish any combination of brake, throttle and steering commands
+ *        back-to-back with a single system call.
+ *
+ * @param [in] commands - Pointer to \ref oscc_command_set_s describing which
+ *                        commands to send and their values.
+ *
+ * @return OSCC_ERROR if commands is NULL, selects no command or could not be
+ *         sent, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_publish_commands( const oscc_command_set_s * commands );
+
+
+/**
+ * @brief Register callback function to be called when brake report
+ *        received from brake module.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        brake report received from brake module.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_brake_reports( void( *callback )( oscc_brake_report_s *report ) );
+
+
+/**
+ * @brief Register callback function to be called when throttle report
+ *        received from throttle module.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        throttle report received from throttle module.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_throttle_reports( void( *callback )( oscc_throttle_report_s *report ) );
+
+
+/**
+ * @brief Register callback function to be called when steering report
+ *        received from steering module.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        steering report received from steering module.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_steering_reports( void( *callback )( oscc_steering_report_s *report ) );
+
+
+/**
+ * @brief Register callback function to be called when fault report
+ *        received from any module.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        fault report received from any module.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_fault_reports( void( *callback )( oscc_fault_report_s *report ) );
+
+
+/**
+ * @brief Register callback function to be called when OBD message received
+ *        from vehicle.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        OBD message received.
+ *
+ * @return OSCC_ERROR or OSCC_OK
  *
  */
 oscc_result_t oscc_subscribe_to_obd_messages( void( *callback )( struct can_frame *frame ) );
 
 
+/**
+ * @brief Register callback function to be called with the receive timestamp
+ *        when brake report received from brake module.
+ *
+ * The timestamp is taken by the network hardware when it supports it and by
+ * the kernel (CLOCK_REALTIME) on arrival otherwise, so it does not include
+ * any delay in delivering the brake report to the process.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        brake report received.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_brake_reports_timestamped(
+    void( *callback )( oscc_brake_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Register callback function to be called with the receive timestamp
+ *        when throttle report received from throttle module.
+ *
+ * The timestamp is taken by the network hardware when it supports it and by
+ * the kernel (CLOCK_REALTIME) on arrival otherwise, so it does not include
+ * any delay in delivering the throttle report to the process.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        throttle report received.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_throttle_reports_timestamped(
+    void( *callback )( oscc_throttle_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Register callback function to be called with the receive timestamp
+ *        when steering report received from steering module.
+ *
+ * The timestamp is taken by the network hardware when it supports it and by
+ * the kernel (CLOCK_REALTIME) on arrival otherwise, so it does not include
+ * any delay in delivering the steering report to the process.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        steering report received.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_steering_reports_timestamped(
+    void( *callback )( oscc_steering_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Register callback function to be called with the receive timestamp
+ *        when fault report received from any module.
+ *
+ * The timestamp is taken by the network hardware when it supports it and by
+ * the kernel (CLOCK_REALTIME) on arrival otherwise, so it does not include
+ * any delay in delivering the fault report to the process.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        fault report received.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_fault_reports_timestamped(
+    void( *callback )( oscc_fault_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Register callback function to be called with the receive timestamp
+ *        when OBD message received from vehicle.
+ *
+ * The timestamp is taken by the network hardware when it supports it and by
+ * the kernel (CLOCK_REALTIME) on arrival otherwise, so it does not include
+ * any delay in delivering the OBD message to the process.
+ *
+ * @param [in] callback - Pointer to callback function to be called when
+ *                        OBD message received.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_obd_messages_timestamped(
+    void( *callback )( struct can_frame *frame, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Watch the brake, throttle and steering reports for modules that go
+ *        silent. A report stream is stale once no report has arrived for
+ *        period_multiple times the period its module publishes at, which a
+ *        timer notices within that time. Every stream starts being watched
+ *        when communications are opened, and a stale stream is watched again
+ *        as soon as its reports resume. The reports are received whether or
+ *        not anything subscribes to them. Must be called before
+ *        \ref oscc_init or \ref oscc_open.
+ *
+ * @param [in] period_multiple - Report periods a stream may miss before it is
+ *                               stale, at least 1, or 0 to stop watching,
+ *                               which is the default.
+ *
+ * @param [in] auto_disable - Whether to disable all modules, as
+ *                            \ref oscc_disable does, when a stream goes
+ *                            stale.
+ *
+ * @return OSCC_ERROR if period_multiple is out of range or communications
+ *         are already open, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_report_watchdog(
+    double period_multiple,
+    bool auto_disable );
+
+
+/**
+ * @brief Register callback function to be called from the watchdog thread
+ *        when a report stream goes stale, see \ref oscc_set_report_watchdog.
+ *
+ * @param [in] callback - Pointer to callback function to be called with the
+ *                        stream that went stale.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_stale_reports(
+    void( *callback )( oscc_report_stream_t stream ) );
+
+
+/**
+ * @brief Limit the OBD messages delivered to the callback registered with
+ *        \ref oscc_subscribe_to_obd_messages to the given CAN IDs. Frames with
+ *        any other ID are discarded by the kernel and never wake the process.
+ *        By default every OBD message is delivered.
+ *
+ * @param [in] can_ids - Array of standard (11-bit) CAN IDs to receive, or NULL
+ *                       to receive every OBD message again.
+ *
+ * @param [in] count - Number of IDs in can_ids, at most
+ *                     \ref OSCC_OBD_FILTER_SIZE_MAX.
+ *
+ * @return OSCC_ERROR if count is too large or the filters could not be
+ *         installed, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_obd_message_filter( const canid_t * can_ids, unsigned int count );
+
+
+/**
+ * @brief Register a handler for every frame received with one standard CAN
+ *        ID, from the OSCC modules or the vehicle. Finding the handler for a
+ *        frame takes a single table lookup however many are registered, so
+ *        there is no need to subscribe to every OBD message and switch over
+ *        the IDs. Frames with no handler or other subscriber are discarded
+ *        by the kernel.
+ *
+ * @param [in] can_id - Standard (11-bit) CAN ID to handle.
+ *
+ * @param [in] handler - Function to call with each frame, or NULL to stop
+ *                       handling the ID.
+ *
+ * @param [in] user_data - Pointer passed to every call of handler.
+ *
+ * @return OSCC_ERROR if can_id is not a standard CAN ID or the filters could
+ *         not be installed, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_subscribe_to_can_id(
+    canid_t can_id,
+    oscc_can_id_handler_t handler,
+    void * user_data );
+
+
+/**
+ * @brief Start keeping the latest reports and OBD values for the
+ *        oscc_get_latest functions, best called before \ref oscc_init or
+ *        \ref oscc_open. Calling it again has no effect.
+ *
+ * @return OSCC_ERROR if the filters letting the reports through could not be
+ *         installed, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_track_snapshots( void );
+
+
+/**
+ * @brief Get a copy of the most recent brake report without registering a
+ *        callback. Safe to call from any number of threads at once, it never
+ *        blocks the thread receiving reports and never blocks itself.
+ *
+ * Reports are only kept once \ref oscc_track_snapshots has been called,
+ * until then every call returns OSCC_WARNING.
+ *
+ * @param [out] snapshot - Pointer to \ref oscc_brake_report_snapshot_s to
+ *                         fill.
+ *
+ * @return OSCC_ERROR if snapshot is NULL, OSCC_WARNING if no brake report has
+ *         been received yet, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_latest_brake_report( oscc_brake_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Get a copy of the most recent steering report, as
+ *        \ref oscc_get_latest_brake_report does for brake reports.
+ *
+ * @param [out] snapshot - Pointer to \ref oscc_steering_report_snapshot_s to
+ *                         fill.
+ *
+ * @return OSCC_ERROR if snapshot is NULL, OSCC_WARNING if no steering report
+ *         has been received yet, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_latest_steering_report( oscc_steering_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Get a copy of the most recent throttle report, as
+ *        \ref oscc_get_latest_brake_report does for brake reports.
+ *
+ * @param [out] snapshot - Pointer to \ref oscc_throttle_report_snapshot_s to
+ *                         fill.
+ *
+ * @return OSCC_ERROR if snapshot is NULL, OSCC_WARNING if no throttle report
+ *         has been received yet, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_latest_throttle_report( oscc_throttle_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Get a copy of the most recent fault report, as
+ *        \ref oscc_get_latest_brake_report does for brake reports.
+ *
+ * @param [out] snapshot - Pointer to \ref oscc_fault_report_snapshot_s to
+ *                         fill.
+ *
+ * @return OSCC_ERROR if snapshot is NULL, OSCC_WARNING if no fault report has
+ *         been received yet, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_latest_fault_report( oscc_fault_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Get the most recent wheel speeds, steering wheel angle and brake
+ *        pressure decoded from vehicle OBD messages, as
+ *        \ref oscc_get_latest_brake_report does for brake reports.
+ *
+ * @param [out] snapshot - Pointer to \ref oscc_obd_snapshot_s to fill.
+ *
+ * @return OSCC_ERROR if snapshot is NULL, OSCC_WARNING if no OBD message has
+ *         been decoded yet, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_get_latest_obd_values( oscc_obd_snapshot_s * snapshot );
+
+
+/**
+ * @brief Select the vehicle whose OBD signal table decodes vehicle messages.
+ *        Defaults to the vehicle the library was built for. Must be called
+ *        before \ref oscc_init or \ref oscc_open.
+ *
+ * @param [in] vehicle - One of \ref oscc_vehicle_t.
+ *
+ * @return OSCC_ERROR if vehicle is unknown or communications are already
+ *         open, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_set_vehicle( oscc_vehicle_t vehicle );
+
+
+/**
+ * @brief Decode every signal an OBD frame carries for the selected vehicle
+ *        in one pass.
+ *
+ * @param [in] frame - OBD frame to decode.
+ *
+ * @param [out] values - Array of \ref OSCC_OBD_SIGNAL_COUNT doubles, indexed
+ *        by \ref oscc_obd_signal_t. Only the decoded signals are written.
+ *
+ * @param [out] decoded - Set to a mask with bit (1 << signal) set for each
+ *        signal written to values.
+ *
+ * @return OSCC_ERROR if a parameter is NULL or the selected vehicle carries
+ *         no signals in the frame, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_decode_obd_frame(
+    const struct can_frame * frame,
+    double * values,
+    unsigned int * decoded );
+
+
+/**
+ * @brief Decode all four wheel speeds of the selected vehicle's wheel speed
+ *        frame at once. (kph)
+ *
+ * @param [in] frame - Wheel speed frame to decode.
+ *
+ * @param [out] wheel_speeds - Array of \ref OSCC_WHEEL_SPEED_COUNT doubles,
+ *        set to the left front, right front, left rear and right rear wheel
+ *        speeds.
+ *
+ * @return OSCC_ERROR if a parameter is NULL or frame is not the selected
+ *         vehicle's wheel speed frame, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_decode_wheel_speeds(
+    const struct can_frame * frame,
+    double * wheel_speeds );
+
+
+/**
+ * @brief Decode the wheel speeds of many frames at once, e.g. from a log, as
+ *        \ref oscc_decode_wheel_speeds does for one.
+ *
+ * @param [in] frames - Array of count wheel speed frames.
+ *
+ * @param [in] count - Number of frames to decode.
+ *
+ * @param [out] wheel_speeds - Array of count * \ref OSCC_WHEEL_SPEED_COUNT
+ *        doubles, set to the four wheel speeds of each frame in turn.
+ *
+ * @return OSCC_ERROR if a parameter is NULL or any frame is not the selected
+ *         vehicle's wheel speed frame, in which case nothing is decoded,
+ *         otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_decode_wheel_speeds_array(
+    const struct can_frame * frames,
+    size_t count,
+    double * wheel_speeds );
+
+
+/**
+ * @brief Get the context used by every function that does not take one.
+ *        It always exists and cannot be destroyed.
+ *
+ * @return Pointer to the default context
+ *
+ */
+oscc_context_t * oscc_default_context( void );
+
+
+/**
+ * @brief Create a context with nothing opened and no callbacks, in
+ *        \ref OSCC_RECEIVE_MODE_SIGNAL. Auto detection by
+ *        \ref oscc_context_init or \ref oscc_context_open skips CAN channels
+ *        already opened by another context.
+ *
+ * @param [out] context - Set to the new context.
+ *
+ * @return OSCC_ERROR if context is NULL, memory ran out or
+ *         \ref OSCC_CONTEXT_COUNT_MAX contexts already exist, otherwise
+ *         OSCC_OK
+ *
+ */
+oscc_result_t oscc_context_create( oscc_context_t ** context );
+
+
+/**
+ * @brief Close a context's communications if they are open and free it.
+ *
+ * @param [in] context - Context created by \ref oscc_context_create.
+ *
+ * @return OSCC_ERROR if context is NULL, is the default context or could not
+ *         be closed cleanly, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_context_destroy( oscc_context_t * context );
+
+
+/**
+ * @brief Attach an arbitrary pointer to a context, for callbacks to retrieve
+ *        through \ref oscc_context_current and
+ *        \ref oscc_context_get_user_data.
+ *
+ * @param [in] context - Context to attach the pointer to.
+ *
+ * @param [in] user_data - Pointer to attach.
+ *
+ * @return OSCC_ERROR if context is NULL, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_context_set_user_data( oscc_context_t * context, void * user_data );
+
+
+/**
+ * @brief Get the pointer attached with \ref oscc_context_set_user_data.
+ *
+ * @param [in] context - Context the pointer was attached to.
+ *
+ * @return The attached pointer, or NULL if there is none or context is NULL
+ *
+ */
+void * oscc_context_get_user_data( const oscc_context_t * context );
+
+
+/**
+ * @brief Get the context whose callback is running on the calling thread, so
+ *        a callback shared by several contexts can tell them apart.
+ *
+ * @return The context delivering the current callback, or NULL when not
+ *         called from a callback
+ *
+ */
+oscc_context_t * oscc_context_current( void );
+
+
+/**
+ * @brief Same as \ref oscc_init for the given context.
+ */
+oscc_result_t oscc_context_init( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_open for the given context.
+ */
+oscc_result_t oscc_context_open( oscc_context_t * context, unsigned int channel );
+
+
+/**
+ * @brief Open communications on CAN channels given by interface name, without
+ *        any auto detection.
+ *
+ * @param [in] context - Context to open communications for.
+ *
+ * @param [in] oscc_can_channel - Interface connected to the OSCC modules,
+ *                                e.g. "can0" or "vcan3".
+ *
+ * @param [in] vehicle_can_channel - Interface connected to the vehicle, or
+ *                                   NULL if the OSCC CAN gateway forwards
+ *                                   vehicle CAN.
+ *
+ * @return OSCC_ERROR or OSCC_OK
+ *
+ */
+oscc_result_t oscc_context_open_channels(
+    oscc_context_t * context,
+    const char * oscc_can_channel,
+    const char * vehicle_can_channel );
+
+
+/**
+ * @brief Same as \ref oscc_close for the given context.
+ */
+oscc_result_t oscc_context_close( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_enable for the given context.
+ */
+oscc_result_t oscc_context_enable( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_disable for the given context.
+ */
+oscc_result_t oscc_context_disable( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_enable_confirmed for the given context.
+ */
+oscc_result_t oscc_context_enable_confirmed(
+    oscc_context_t * context,
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation );
+
+
+/**
+ * @brief Same as \ref oscc_disable_confirmed for the given context.
+ */
+oscc_result_t oscc_context_disable_confirmed(
+    oscc_context_t * context,
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation );
+
+
+/**
+ * @brief Same as \ref oscc_publish_brake_position for the given context.
+ */
+oscc_result_t oscc_context_publish_brake_position(
+    oscc_context_t * context,
+    double brake_position );
+
+
+/**
+ * @brief Same as \ref oscc_publish_throttle_position for the given context.
+ */
+oscc_result_t oscc_context_publish_throttle_position(
+    oscc_context_t * context,
+    double throttle_position );
+
+
+/**
+ * @brief Same as \ref oscc_publish_steering_torque for the given context.
+ */
+oscc_result_t oscc_context_publish_steering_torque(
+    oscc_context_t * context,
+    double torque );
+
+
+/**
+ * @brief Same as \ref oscc_publish_commands for the given context.
+ */
+oscc_result_t oscc_context_publish_commands(
+    oscc_context_t * context,
+    const oscc_command_set_s * commands );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_brake_reports for the given context.
+ */
+oscc_result_t oscc_context_subscribe_to_brake_reports(
+    oscc_context_t * context,
+    void( *callback )( oscc_brake_report_s *report ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_throttle_reports for the given
+ *        context.
+ */
+oscc_result_t oscc_context_subscribe_to_throttle_reports(
+    oscc_context_t * context,
+    void( *callback )( oscc_throttle_report_s *report ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_steering_reports for the given
+ *        context.
+ */
+oscc_result_t oscc_context_subscribe_to_steering_reports(
+    oscc_context_t * context,
+    void( *callback )( oscc_steering_report_s *report ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_fault_reports for the given context.
+ */
+oscc_result_t oscc_context_subscribe_to_fault_reports(
+    oscc_context_t * context,
+    void( *callback )( oscc_fault_report_s *report ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_obd_messages for the given context.
+ */
+oscc_result_t oscc_context_subscribe_to_obd_messages(
+    oscc_context_t * context,
+    void( *callback )( struct can_frame *frame ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_brake_reports_timestamped for the
+ *        given context.
+ */
+oscc_result_t oscc_context_subscribe_to_brake_reports_timestamped(
+    oscc_context_t * context,
+    void( *callback )( oscc_brake_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_throttle_reports_timestamped for the
+ *        given context.
+ */
+oscc_result_t oscc_context_subscribe_to_throttle_reports_timestamped(
+    oscc_context_t * context,
+    void( *callback )( oscc_throttle_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_steering_reports_timestamped for the
+ *        given context.
+ */
+oscc_result_t oscc_context_subscribe_to_steering_reports_timestamped(
+    oscc_context_t * context,
+    void( *callback )( oscc_steering_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_fault_reports_timestamped for the
+ *        given context.
+ */
+oscc_result_t oscc_context_subscribe_to_fault_reports_timestamped(
+    oscc_context_t * context,
+    void( *callback )( oscc_fault_report_s *report, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_obd_messages_timestamped for the
+ *        given context.
+ */
+oscc_result_t oscc_context_subscribe_to_obd_messages_timestamped(
+    oscc_context_t * context,
+    void( *callback )( struct can_frame *frame, const struct timespec *timestamp ) );
+
+
+/**
+ * @brief Same as \ref oscc_set_report_watchdog for the given context.
+ */
+oscc_result_t oscc_context_set_report_watchdog(
+    oscc_context_t * context,
+    double period_multiple,
+    bool auto_disable );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_stale_reports for the given context.
+ */
+oscc_result_t oscc_context_subscribe_to_stale_reports(
+    oscc_context_t * context,
+    void( *callback )( oscc_report_stream_t stream ) );
+
+
+/**
+ * @brief Same as \ref oscc_set_obd_message_filter for the given context.
+ */
+oscc_result_t oscc_context_set_obd_message_filter(
+    oscc_context_t * context,
+    const canid_t * can_ids,
+    unsigned int count );
+
+
+/**
+ * @brief Same as \ref oscc_subscribe_to_can_id for the given context.
+ */
+oscc_result_t oscc_context_subscribe_to_can_id(
+    oscc_context_t * context,
+    canid_t can_id,
+    oscc_can_id_handler_t handler,
+    void * user_data );
+
+
+/**
+ * @brief Same as \ref oscc_set_receive_mode for the given context. Contexts
+ *        may use different modes.
+ */
+oscc_result_t oscc_context_set_receive_mode(
+    oscc_context_t * context,
+    oscc_receive_mode_t mode );
+
+
+/**
+ * @brief Same as \ref oscc_get_receive_threads for the given context. Each
+ *        context in \ref OSCC_RECEIVE_MODE_THREAD has threads of its own.
+ */
+oscc_result_t oscc_context_get_receive_threads(
+    oscc_context_t * context,
+    pthread_t * receive_thread,
+    pthread_t * dispatch_thread );
+
+
+/**
+ * @brief Same as \ref oscc_set_receive_realtime for the given context.
+ */
+oscc_result_t oscc_context_set_receive_realtime(
+    oscc_context_t * context,
+    int priority,
+    int cpu,
+    bool lock_memory );
+
+
+/**
+ * @brief Same as \ref oscc_set_io_backend for the given context.
+ */
+oscc_result_t oscc_context_set_io_backend(
+    oscc_context_t * context,
+    oscc_io_backend_t backend );
+
+
+/**
+ * @brief Same as \ref oscc_get_io_backend for the given context.
+ */
+oscc_result_t oscc_context_get_io_backend(
+    oscc_context_t * context,
+    oscc_io_backend_t * backend );
+
+
+/**
+ * @brief Same as \ref oscc_set_busy_poll for the given context.
+ */
+oscc_result_t oscc_context_set_busy_poll(
+    oscc_context_t * context,
+    const oscc_busy_poll_s * busy_poll );
+
+
+/**
+ * @brief Same as \ref oscc_get_fds for the given context.
+ */
+oscc_result_t oscc_context_get_fds(
+    oscc_context_t * context,
+    int * fds,
+    unsigned int * count );
+
+
+/**
+ * @brief Same as \ref oscc_process_pending for the given context.
+ */
+oscc_result_t oscc_context_process_pending(
+    oscc_context_t * context,
+    unsigned int max_frames,
+    unsigned int * frames_processed );
+
+
+/**
+ * @brief Same as \ref oscc_set_receive_batch_size for the given context.
+ */
+oscc_result_t oscc_context_set_receive_batch_size(
+    oscc_context_t * context,
+    unsigned int size );
+
+
+/**
+ * @brief Same as \ref oscc_get_receive_counters for the given context.
+ */
+oscc_result_t oscc_context_get_receive_counters(
+    oscc_context_t * context,
+    oscc_receive_counters_s * counters );
+
+
+/**
+ * @brief Same as \ref oscc_get_can_id_counters for the given context.
+ */
+oscc_result_t oscc_context_get_can_id_counters(
+    oscc_context_t * context,
+    oscc_can_bus_t bus,
+    canid_t can_id,
+    oscc_can_id_counters_s * counters );
+
+
+/**
+ * @brief Same as \ref oscc_get_bus_stats for the given context.
+ */
+oscc_result_t oscc_context_get_bus_stats(
+    oscc_context_t * context,
+    oscc_can_bus_t bus,
+    oscc_bus_stats_s * stats );
+
+
+/**
+ * @brief Same as \ref oscc_start_recording for the given context.
+ */
+oscc_result_t oscc_context_start_recording(
+    oscc_context_t * context,
+    const char * path );
+
+
+/**
+ * @brief Same as \ref oscc_stop_recording for the given context.
+ */
+oscc_result_t oscc_context_stop_recording( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_replay for the given context.
+ */
+oscc_result_t oscc_context_replay(
+    oscc_context_t * context,
+    const char * path,
+    double speed );
+
+
+/**
+ * @brief Same as \ref oscc_set_transmit_rate for the given context.
+ */
+oscc_result_t oscc_context_set_transmit_rate(
+    oscc_context_t * context,
+    unsigned int rate );
+
+
+/**
+ * @brief Same as \ref oscc_flush_commands for the given context.
+ */
+oscc_result_t oscc_context_flush_commands( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_get_priority_latency for the given context.
+ */
+oscc_result_t oscc_context_get_priority_latency(
+    oscc_context_t * context,
+    oscc_priority_latency_s * latency );
+
+
+/**
+ * @brief Same as \ref oscc_get_stats for the given context.
+ */
+oscc_result_t oscc_context_get_stats(
+    oscc_context_t * context,
+    oscc_stats_s * stats );
+
+
+/**
+ * @brief Same as \ref oscc_reset_stats for the given context.
+ */
+oscc_result_t oscc_context_reset_stats( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_set_stats_bounds for the given context.
+ */
+oscc_result_t oscc_context_set_stats_bounds(
+    oscc_context_t * context,
+    const uint64_t * bounds_ns,
+    unsigned int count );
+
+
+/**
+ * @brief Same as \ref oscc_print_stats for the given context.
+ */
+oscc_result_t oscc_context_print_stats(
+    oscc_context_t * context,
+    FILE * stream );
+
+
+/**
+ * @brief Same as \ref oscc_track_snapshots for the given context.
+ */
+oscc_result_t oscc_context_track_snapshots( oscc_context_t * context );
+
+
+/**
+ * @brief Same as \ref oscc_get_latest_brake_report for the given context.
+ */
+oscc_result_t oscc_context_get_latest_brake_report(
+    oscc_context_t * context,
+    oscc_brake_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Same as \ref oscc_get_latest_steering_report for the given context.
+ */
+oscc_result_t oscc_context_get_latest_steering_report(
+    oscc_context_t * context,
+    oscc_steering_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Same as \ref oscc_get_latest_throttle_report for the given context.
+ */
+oscc_result_t oscc_context_get_latest_throttle_report(
+    oscc_context_t * context,
+    oscc_throttle_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Same as \ref oscc_get_latest_fault_report for the given context.
+ */
+oscc_result_t oscc_context_get_latest_fault_report(
+    oscc_context_t * context,
+    oscc_fault_report_snapshot_s * snapshot );
+
+
+/**
+ * @brief Same as \ref oscc_get_latest_obd_values for the given context.
+ */
+oscc_result_t oscc_context_get_latest_obd_values(
+    oscc_context_t * context,
+    oscc_obd_snapshot_s * snapshot );
+
+
+/**
+ * @brief Same as \ref oscc_set_vehicle for the given context.
+ */
+oscc_result_t oscc_context_set_vehicle(
+    oscc_context_t * context,
+    oscc_vehicle_t vehicle );
+
+
+/**
+ * @brief Same as \ref oscc_decode_obd_frame for the given context.
+ */
+oscc_result_t oscc_context_decode_obd_frame(
+    const oscc_context_t * context,
+    const struct can_frame * frame,
+    double * values,
+    unsigned int * decoded );
+
+
+/**
+ * @brief Same as \ref oscc_decode_wheel_speeds for the given context.
+ */
+oscc_result_t oscc_context_decode_wheel_speeds(
+    const oscc_context_t * context,
+    const struct can_frame * frame,
+    double * wheel_speeds );
+
+
+/**
+ * @brief Same as \ref oscc_decode_wheel_speeds_array for the given context.
+ */
+oscc_result_t oscc_context_decode_wheel_speeds_array(
+    const oscc_context_t * context,
+    const struct can_frame * frames,
+    size_t count,
+    double * wheel_speeds );
+
+
+/**
+ * @brief Keep a context's latest report and OBD snapshots in POSIX shared
+ *        memory so other processes can read them with
+ *        \ref oscc_context_attach_snapshots. Starts tracking the snapshots
+ *        straight away. Must be called before communications are opened.
+ *        The shared memory object is removed when the context is destroyed.
+ *
+ * @param [in] context - Context whose snapshots to share.
+ *
+ * @param [in] name - Name of the shared memory object, e.g. "/oscc_vehicle_a".
+ *
+ * @return OSCC_ERROR if a parameter is NULL, communications are open, the
+ *         snapshots are already mapped or the shared memory could not be
+ *         created, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_context_share_snapshots( oscc_context_t * context, const char * name );
+
+
+/**
+ * @brief Make a context read the snapshots another process shares with
+ *        \ref oscc_context_share_snapshots instead of its own. The context
+ *        should not open communications itself; its oscc_context_get_latest
+ *        functions then report the other process's vehicle.
+ *
+ * @param [in] context - Context that will read the shared snapshots.
+ *
+ * @param [in] name - Name the snapshots were shared under.
+ *
+ * @return OSCC_ERROR if a parameter is NULL, communications are open, the
+ *         snapshots are already mapped or no compatible snapshots are shared
+ *         under name, otherwise OSCC_OK
+ *
+ */
+oscc_result_t oscc_context_attach_snapshots( oscc_context_t * context, const char * name );
+
+
 /**
  * @brief Set vehicle right rear wheel speed in kph from CAN frame. (kph)
  *
@@ -216,7 +2085,7 @@ oscc_result_t oscc_subscribe_to_obd_messages( void( *callback )( struct can_fram
  * @return:
  * \li \ref OSCC_OK on successful unpacking.
  * \li \ref OSCC_ERROR if a parameter is NULL or the CAN frame ID is not
- * \ref KIA_SOUL_OBD_WHEEL_SPEED_CAN_ID
+ * that of the wheel speed frame of the vehicle selected with \ref oscc_set_vehicle
  */
 oscc_result_t get_wheel_speed_right_rear(
     struct can_frame const * const frame,
@@ -234,7 +2103,7 @@ oscc_result_t get_wheel_speed_right_rear(
  * @return:
  * \li \ref OSCC_OK on successful unpacking.
  * \li \ref OSCC_ERROR if a parameter is NULL or the CAN frame ID is not
- * \ref KIA_SOUL_OBD_WHEEL_SPEED_CAN_ID
+ * that of the wheel speed frame of the vehicle selected with \ref oscc_set_vehicle
  */
 oscc_result_t get_wheel_speed_left_rear(
     struct can_frame const * const frame,
@@ -253,7 +2122,7 @@ oscc_result_t get_wheel_speed_left_rear(
  * @return:
  * \li \ref OSCC_OK on successful unpacking.
  * \li \ref OSCC_ERROR if a parameter is NULL or the CAN frame ID is not
- * \ref KIA_SOUL_OBD_WHEEL_SPEED_CAN_ID
+ * that of the wheel speed frame of the vehicle selected with \ref oscc_set_vehicle
  */
 oscc_result_t get_wheel_speed_right_front(
     struct can_frame const * const frame,
@@ -272,7 +2141,7 @@ oscc_result_t get_wheel_speed_right_front(
  * @return:
  * \li \ref OSCC_OK on successful unpacking.
  * \li \ref OSCC_ERROR if a parameter is NULL or the CAN frame ID is not
- * \ref KIA_SOUL_OBD_WHEEL_SPEED_CAN_ID
+ * that of the wheel speed frame of the vehicle selected with \ref oscc_set_vehicle
  */
 oscc_result_t get_wheel_speed_left_front(
     struct can_frame const * const frame,
@@ -291,7 +2160,7 @@ oscc_result_t get_wheel_speed_left_front(
  * @return:
  * \li \ref OSCC_OK on successful unpacking.
  * \li \ref OSCC_ERROR if a parameter is NULL or the CAN frame ID is not
- * \ref KIA_SOUL_OBD_STEERING_WHEEL_ANGLE_CAN_ID
+ * that of the steering wheel angle frame of the vehicle selected with \ref oscc_set_vehicle
  */
 oscc_result_t get_steering_wheel_angle(
     struct can_frame const * const frame,
@@ -310,7 +2179,7 @@ oscc_result_t get_steering_wheel_angle(
  * @return:
  * \li \ref OSCC_OK on successful unpacking.
  * \li \ref OSCC_ERROR if a parameter is NULL or the CAN frame ID is not
- * \ref KIA_SOUL_OBD_BRAKE_PRESSURE_CAN_ID
+ * that of the brake pressure frame of the vehicle selected with \ref oscc_set_vehicle
  */
 oscc_result_t get_brake_pressure(
     struct can_frame const * const frame,
@@ -0,0 +1,514 @@
+/**
+ * @file oscc.hpp
+ * @brief Header-only C++17 interface over oscc.h. Handlers are stored inside
+ *        the context object and called through trampolines generated for
+ *        their exact type, so they inline into the dispatch code without
+ *        virtual calls or heap allocations.
+ */
+
+
+#ifndef _OSCC_HPP
+#define _OSCC_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+extern "C"
+{
+#include "oscc.h"
+}
+
+
+namespace oscc
+{
+
+
+/*
+ * @brief Largest handler in bytes a context can store, enough for a lambda
+ * capturing a few pointers. Larger handlers fail to compile.
+ *
+ */
+constexpr std::size_t handler_size_max = 4 * sizeof(void *);
+
+
+/*
+ * @brief Largest number of handlers registered with
+ * \ref context::on_can_id that a context can store.
+ *
+ */
+constexpr std::size_t can_id_handlers_max = 16;
+
+
+/*
+ * @brief View of a brake, throttle or steering report, reading the fields
+ *        straight from the received frame. Only valid during the handler it
+ *        is passed to.
+ *
+ */
+template <typename Report>
+class module_report
+{
+public:
+    explicit module_report( const Report & report ) : report_( &report ) {}
+
+    bool enabled( ) const { return ( report_->enabled != 0 ); }
+
+    bool operator_override( ) const { return ( report_->operator_override != 0 ); }
+
+    std::uint8_t dtcs( ) const { return report_->dtcs; }
+
+    const Report & raw( ) const { return *report_; }
+
+private:
+    const Report * report_;
+};
+
+using brake_report = module_report<oscc_brake_report_s>;
+using throttle_report = module_report<oscc_throttle_report_s>;
+using steering_report = module_report<oscc_steering_report_s>;
+
+
+/*
+ * @brief View of a fault report. Only valid during the handler it is passed
+ *        to.
+ *
+ */
+class fault_report
+{
+public:
+    explicit fault_report( const oscc_fault_report_s & report ) : report_( &report ) {}
+
+    std::uint32_t fault_origin_id( ) const { return report_->fault_origin_id; }
+
+    std::uint8_t dtcs( ) const { return report_->dtcs; }
+
+    const oscc_fault_report_s & raw( ) const { return *report_; }
+
+private:
+    const oscc_fault_report_s * report_;
+};
+
+
+/*
+ * @brief View of a received CAN frame. Only valid during the handler it is
+ *        passed to.
+ *
+ */
+class frame_view
+{
+public:
+    explicit frame_view( const struct can_frame & frame ) : frame_( &frame ) {}
+
+    canid_t id( ) const { return frame_->can_id; }
+
+    std::size_t size( ) const { return frame_->can_dlc; }
+
+    const std::uint8_t * data( ) const { return frame_->data; }
+
+    std::uint8_t operator[]( std::size_t index ) const { return frame_->data[index]; }
+
+    const struct can_frame & raw( ) const { return *frame_; }
+
+private:
+    const struct can_frame * frame_;
+};
+
+
+namespace detail
+{
+
+// A command whose value is checked against [Limits::min, Limits::max]. Out of
+// range values are a compile error when the command is built in a constant
+// expression, and are clamped otherwise, with NaN becoming 0.
+template <typename Limits>
+class bounded_command
+{
+public:
+    static constexpr double min = Limits::min;
+    static constexpr double max = Limits::max;
+
+    constexpr explicit bounded_command( double value )
+        : value_( ((value >= min) && (value <= max)) ? value : out_of_range( value ) ) {}
+
+    constexpr double value( ) const { return value_; }
+
+private:
+    // Deliberately not constexpr, so reaching it while evaluating a constant
+    // expression fails to compile
+    static double out_of_range( double value )
+    {
+        return ( value < min ) ? min : ( (value > max) ? max : 0.0 );
+    }
+
+    double value_;
+};
+
+struct brake_limits
+{
+    static constexpr double min = 0.0;
+    static constexpr double max = 1.0;
+};
+
+struct throttle_limits
+{
+    static constexpr double min = 0.0;
+    static constexpr double max = 1.0;
+};
+
+struct steering_limits
+{
+    static constexpr double min = -1.0;
+    static constexpr double max = 1.0;
+};
+
+} // namespace detail
+
+
+/*
+ * @brief Normalized brake pedal position [0, 1].
+ *
+ */
+using brake_position = detail::bounded_command<detail::brake_limits>;
+
+/*
+ * @brief Normalized throttle pedal position [0, 1].
+ *
+ */
+using throttle_position = detail::bounded_command<detail::throttle_limits>;
+
+/*
+ * @brief Normalized steering wheel torque [-1, 1].
+ *
+ */
+using steering_torque = detail::bounded_command<detail::steering_limits>;
+
+
+/*
+ * @brief A C context together with the handlers registered on it.
+ *
+ * The context attaches itself as the C context's user data to find its
+ * handlers, so that must not be replaced, and it can neither be copied nor
+ * moved. Handlers are copied into the context and must be trivially
+ * copyable and destructible, which lambdas capturing pointers, references
+ * and numbers are. A handler may be replaced only while no callback of its
+ * kind can run.
+ *
+ */
+class context
+{
+public:
+    // Creates a C context of its own, check valid() before use
+    context( )
+        : context_( nullptr ),
+          owned_( true )
+    {
+        if ( oscc_context_create( &context_ ) != OSCC_OK )
+        {
+            context_ = nullptr;
+        }
+
+        attach( );
+    }
+
+    // Wraps an existing C context, such as oscc_default_context(), whose
+    // communications are closed again when this is destroyed
+    explicit context( oscc_context_t * native )
+        : context_( native ),
+          owned_( false )
+    {
+        attach( );
+    }
+
+    ~context( )
+    {
+        if ( context_ == nullptr )
+        {
+            // Nothing was created
+        }
+        else if ( owned_ == true )
+        {
+            oscc_context_destroy( context_ );
+        }
+        else
+        {
+            // No callback may reach this object once it is gone
+            oscc_context_close( context_ );
+            oscc_context_set_user_data( context_, nullptr );
+        }
+    }
+
+    context( const context & ) = delete;
+    context & operator=( const context & ) = delete;
+
+    bool valid( ) const { return ( context_ != nullptr ); }
+
+    oscc_context_t * native_handle( ) const { return context_; }
+
+    oscc_result_t init( ) { return oscc_context_init( context_ ); }
+
+    oscc_result_t open( unsigned int channel ) { return oscc_context_open( context_, channel ); }
+
+    oscc_result_t close( ) { return oscc_context_close( context_ ); }
+
+    oscc_result_t enable( ) { return oscc_context_enable( context_ ); }
+
+    oscc_result_t disable( ) { return oscc_context_disable( context_ ); }
+
+    oscc_result_t enable_confirmed( unsigned int timeout_ms, oscc_confirmation_s & confirmation )
+    {
+        return oscc_context_enable_confirmed( context_, timeout_ms, &confirmation );
+    }
+
+    oscc_result_t disable_confirmed( unsigned int timeout_ms, oscc_confirmation_s & confirmation )
+    {
+        return oscc_context_disable_confirmed( context_, timeout_ms, &confirmation );
+    }
+
+    // Publishes one command, or several at once as
+    // oscc_context_publish_commands does
+    template <typename... Commands>
+    oscc_result_t publish( Commands... commands )
+    {
+        static_assert( sizeof...(Commands) > 0, "Nothing to publish" );
+
+        if constexpr ( sizeof...(Commands) == 1 )
+        {
+            return publish_one( commands... );
+        }
+        else
+        {
+            oscc_command_set_s command_set = { };
+
+            ( add_command( command_set, commands ), ... );
+
+            return oscc_context_publish_commands( context_, &command_set );
+        }
+    }
+
+    // Each report handler is called with the report view, and with the
+    // receive timestamp as well if it accepts one
+    template <typename Handler>
+    oscc_result_t on_brake_report( Handler handler )
+    {
+        store( handlers_[handler_brake], handler );
+
+        return oscc_context_subscribe_to_brake_reports_timestamped(
+            context_,
+            report_trampoline<handler_brake, brake_report, Handler, oscc_brake_report_s> );
+    }
+
+    template <typename Handler>
+    oscc_result_t on_throttle_report( Handler handler )
+    {
+        store( handlers_[handler_throttle], handler );
+
+        return oscc_context_subscribe_to_throttle_reports_timestamped(
+            context_,
+            report_trampoline<handler_throttle, throttle_report, Handler, oscc_throttle_report_s> );
+    }
+
+    template <typename Handler>
+    oscc_result_t on_steering_report( Handler handler )
+    {
+        store( handlers_[handler_steering], handler );
+
+        return oscc_context_subscribe_to_steering_reports_timestamped(
+            context_,
+            report_trampoline<handler_steering, steering_report, Handler, oscc_steering_report_s> );
+    }
+
+    template <typename Handler>
+    oscc_result_t on_fault_report( Handler handler )
+    {
+        store( handlers_[handler_fault], handler );
+
+        return oscc_context_subscribe_to_fault_reports_timestamped(
+            context_,
+            report_trampoline<handler_fault, fault_report, Handler, oscc_fault_report_s> );
+    }
+
+    template <typename Handler>
+    oscc_result_t on_obd_frame( Handler handler )
+    {
+        store( handlers_[handler_obd], handler );
+
+        return oscc_context_subscribe_to_obd_messages_timestamped(
+            context_,
+            report_trampoline<handler_obd, frame_view, Handler, struct can_frame> );
+    }
+
+    // Called with the oscc_report_stream_t that went stale
+    template <typename Handler>
+    oscc_result_t on_stale_report( Handler handler )
+    {
+        store( handlers_[handler_stale], handler );
+
+        return oscc_context_subscribe_to_stale_reports( context_, stale_trampoline<Handler> );
+    }
+
+    // Called with a frame_view of every frame with the CAN ID, and with the
+    // receive timestamp as well if it accepts one. Fails once
+    // can_id_handlers_max handlers are registered.
+    template <typename Handler>
+    oscc_result_t on_can_id( canid_t can_id, Handler handler )
+    {
+        oscc_result_t result = OSCC_ERROR;
+
+        if ( can_id_handler_count_ < can_id_handlers_max )
+        {
+            handler_slot & slot = can_id_handlers_[can_id_handler_count_];
+
+            store( slot, handler );
+
+            result = oscc_context_subscribe_to_can_id(
+                context_,
+                can_id,
+                can_id_trampoline<Handler>,
+                &slot );
+
+            if ( result == OSCC_OK )
+            {
+                can_id_handler_count_++;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    enum handler_kind
+    {
+        handler_brake,
+        handler_throttle,
+        handler_steering,
+        handler_fault,
+        handler_obd,
+        handler_stale,
+        handler_kind_count
+    };
+
+    struct handler_slot
+    {
+        alignas( std::max_align_t ) unsigned char storage[handler_size_max];
+    };
+
+    void attach( )
+    {
+        if ( context_ != nullptr )
+        {
+            oscc_context_set_user_data( context_, this );
+        }
+    }
+
+    template <typename Handler>
+    static void store( handler_slot & slot, Handler & handler )
+    {
+        static_assert( sizeof(Handler) <= handler_size_max,
+                       "Handler is larger than oscc::handler_size_max" );
+        static_assert( alignof(Handler) <= alignof(std::max_align_t),
+                       "Handler is over-aligned" );
+        static_assert( std::is_trivially_copyable_v<Handler>
+                           && std::is_trivially_destructible_v<Handler>,
+                       "Handler must be trivially copyable and destructible" );
+
+        ::new ( static_cast<void *>( slot.storage ) ) Handler( handler );
+    }
+
+    template <typename Handler>
+    static Handler & stored( handler_slot & slot )
+    {
+        return *std::launder( reinterpret_cast<Handler *>( slot.storage ) );
+    }
+
+    // The C context delivering a callback finds its way back to this object
+    static context & current( )
+    {
+        return *static_cast<context *>( oscc_context_get_user_data( oscc_context_current( ) ) );
+    }
+
+    template <typename Handler, typename View>
+    static void invoke( Handler & handler, const View & view, const struct timespec & timestamp )
+    {
+        if constexpr ( std::is_invocable_v<Handler &, const View &, const struct timespec &> )
+        {
+            handler( view, timestamp );
+        }
+        else
+        {
+            handler( view );
+        }
+    }
+
+    template <handler_kind Kind, typename View, typename Handler, typename Report>
+    static void report_trampoline( Report * report, const struct timespec * timestamp )
+    {
+        invoke( stored<Handler>( current( ).handlers_[Kind] ), View( *report ), *timestamp );
+    }
+
+    template <typename Handler>
+    static void stale_trampoline( oscc_report_stream_t stream )
+    {
+        stored<Handler>( current( ).handlers_[handler_stale] )( stream );
+    }
+
+    template <typename Handler>
+    static void can_id_trampoline(
+        const struct can_frame * frame,
+        const struct timespec * timestamp,
+        void * user_data )
+    {
+        invoke(
+            stored<Handler>( *static_cast<handler_slot *>( user_data ) ),
+            frame_view( *frame ),
+            *timestamp );
+    }
+
+    oscc_result_t publish_one( brake_position command )
+    {
+        return oscc_context_publish_brake_position( context_, command.value( ) );
+    }
+
+    oscc_result_t publish_one( throttle_position command )
+    {
+        return oscc_context_publish_throttle_position( context_, command.value( ) );
+    }
+
+    oscc_result_t publish_one( steering_torque command )
+    {
+        return oscc_context_publish_steering_torque( context_, command.value( ) );
+    }
+
+    static void add_command( oscc_command_set_s & command_set, brake_position command )
+    {
+        command_set.publish_brake = true;
+        command_set.brake_position = command.value( );
+    }
+
+    static void add_command( oscc_command_set_s & command_set, throttle_position command )
+    {
+        command_set.publish_throttle = true;
+        command_set.throttle_position = command.value( );
+    }
+
+    static void add_command( oscc_command_set_s & command_set, steering_torque command )
+    {
+        command_set.publish_steering = true;
+        command_set.steering_torque = command.value( );
+    }
+
+    oscc_context_t * context_;
+    bool owned_;
+    handler_slot handlers_[handler_kind_count] = { };
+    handler_slot can_id_handlers_[can_id_handlers_max] = { };
+    std::size_t can_id_handler_count_ = 0;
+};
+
+
+} // namespace oscc
+
+
+#endif /* _OSCC_HPP */
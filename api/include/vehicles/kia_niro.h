@@ -67,6 +67,39 @@
  */
 #define KIA_SOUL_OBD_STEERING_ANGLE_SCALAR ( 0.1 )
 
+/*
+ * @brief The Kia Niro's OBD frames decoded by the API.
+ *
+ */
+#define KIA_SOUL_OBD_FRAMES( FRAME ) \
+    FRAME( KIA_SOUL_OBD_WHEEL_SPEED_CAN_ID, KIA_SOUL_OBD_WHEEL_SPEED_SIGNALS ) \
+    FRAME( KIA_SOUL_OBD_STEERING_WHEEL_ANGLE_CAN_ID, KIA_SOUL_OBD_STEERING_WHEEL_ANGLE_SIGNALS ) \
+    FRAME( KIA_SOUL_OBD_BRAKE_PRESSURE_CAN_ID, KIA_SOUL_OBD_BRAKE_PRESSURE_SIGNALS )
+
+/*
+ * @brief Signals of the Kia Niro's OBD wheel speed CAN frame (kph).
+ *
+ */
+#define KIA_SOUL_OBD_WHEEL_SPEED_SIGNALS( SIGNAL ) \
+    SIGNAL( OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT, 0, 12, false, 0.03125, 0.0 ) \
+    SIGNAL( OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_FRONT, 16, 12, false, 0.03125, 0.0 ) \
+    SIGNAL( OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_REAR, 32, 12, false, 0.03125, 0.0 ) \
+    SIGNAL( OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_REAR, 48, 12, false, 0.03125, 0.0 )
+
+/*
+ * @brief Signals of the Kia Niro's OBD steering wheel angle CAN frame (degrees).
+ *
+ */
+#define KIA_SOUL_OBD_STEERING_WHEEL_ANGLE_SIGNALS( SIGNAL ) \
+    SIGNAL( OSCC_OBD_SIGNAL_STEERING_WHEEL_ANGLE, 0, 16, true, -KIA_SOUL_OBD_STEERING_ANGLE_SCALAR, 0.0 )
+
+/*
+ * @brief Signals of the Kia Niro's OBD brake pressure CAN frame (bar).
+ *
+ */
+#define KIA_SOUL_OBD_BRAKE_PRESSURE_SIGNALS( SIGNAL ) \
+    SIGNAL( OSCC_OBD_SIGNAL_BRAKE_PRESSURE, 24, 12, false, 0.025, 0.0 )
+
 /**
  * @brief Steering wheel angle message data.
  * @warn Deprecated. Use \ref get_steering_wheel_angle instead.
@@ -0,0 +1,438 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <linux/can.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "oscc.h"
+#include "can_protocols/brake_can_protocol.h"
+#include "can_protocols/fault_can_protocol.h"
+#include "can_protocols/steering_can_protocol.h"
+#include "can_protocols/throttle_can_protocol.h"
+#include "internal/broker.h"
+
+
+// Longest the main thread sleeps before checking for signals
+#define BROKER_IDLE_WAIT_NS ( 10000000 )
+
+// How often the main thread checks for dead clients, busy or not
+#define BROKER_RECLAIM_PERIOD_NS ( 100000000 )
+
+
+static broker_region_s * global_region = NULL;
+
+static volatile sig_atomic_t global_stop = 0;
+
+
+static void broker_signal_handler( int signal_number )
+{
+    (void) signal_number;
+
+    global_stop = 1;
+}
+
+// Runs on the receive dispatch thread, the only one publishing frames
+static void broker_report_handler(
+    const struct can_frame * frame,
+    const struct timespec * timestamp,
+    void * user_data )
+{
+    (void) user_data;
+
+    broker_publish_frame( global_region, BROKER_FRAME_REPORT, frame, timestamp, NULL );
+}
+
+static void broker_obd_handler(
+    struct can_frame * frame,
+    const struct timespec * timestamp )
+{
+    oscc_obd_snapshot_s obd;
+
+    // The signals in frame are decoded before this callback runs
+    oscc_get_latest_obd_values( &obd );
+
+    broker_publish_frame( global_region, BROKER_FRAME_OBD, frame, timestamp, &obd );
+}
+
+// Whether the region fd refers to belongs to a broker that is still running
+static bool broker_region_in_use( int fd )
+{
+    bool in_use = false;
+
+    struct stat status;
+
+    const size_t header_size = offsetof( broker_region_s, frame_head );
+
+    if ( (fstat( fd, &status ) == 0) && (status.st_size >= (off_t) header_size) )
+    {
+        broker_region_s * const region = mmap( NULL, header_size, PROT_READ, MAP_SHARED, fd, 0 );
+
+        if ( region != MAP_FAILED )
+        {
+            const pid_t pid = atomic_load( &region->broker_pid );
+
+            in_use = ( region->magic == BROKER_MAGIC )
+                && ( pid != 0 )
+                && ( (kill( pid, 0 ) == 0) || (errno != ESRCH) );
+
+            munmap( region, header_size );
+        }
+    }
+
+    return in_use;
+}
+
+static oscc_result_t broker_create_region( const char * name )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    int fd = shm_open( name, O_CREAT | O_RDWR, 0660 );
+
+    if ( fd < 0 )
+    {
+        perror( "shm_open failed:" );
+    }
+    else if ( broker_region_in_use( fd ) == true )
+    {
+        // Left alone, the running broker and its clients keep working
+        printf( "Error: a broker is already running on %s\n", name );
+
+        close( fd );
+    }
+    else
+    {
+        // Truncating first zeroes whatever a broker that died left behind
+        if ( (ftruncate( fd, 0 ) < 0)
+            || (ftruncate( fd, sizeof(broker_region_s) ) < 0) )
+        {
+            perror( "ftruncate failed:" );
+        }
+        else
+        {
+            void * const mapping = mmap(
+                NULL,
+                sizeof(broker_region_s),
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED,
+                fd,
+                0 );
+
+            if ( mapping == MAP_FAILED )
+            {
+                perror( "mmap failed:" );
+            }
+            else
+            {
+                uint64_t i;
+
+                global_region = mapping;
+
+                for ( i = 0; i < BROKER_COMMAND_RING_SIZE; i++ )
+                {
+                    atomic_init( &global_region->commands[i].sequence, i );
+                }
+
+                atomic_init( &global_region->controller, BROKER_NO_CLIENT );
+                atomic_init( &global_region->broker_pid, getpid( ) );
+
+                global_region->version = BROKER_VERSION;
+                global_region->size = sizeof(broker_region_s);
+
+                // Clients only trust the region once the magic is in place
+                atomic_thread_fence( memory_order_release );
+                global_region->magic = BROKER_MAGIC;
+
+                result = OSCC_OK;
+            }
+        }
+
+        close( fd );
+
+        if ( result != OSCC_OK )
+        {
+            shm_unlink( name );
+        }
+    }
+
+
+    return result;
+}
+
+static void broker_destroy_region( const char * name )
+{
+    global_region->magic = 0;
+    atomic_store( &global_region->broker_pid, 0 );
+
+    munmap( global_region, sizeof(broker_region_s) );
+    global_region = NULL;
+
+    shm_unlink( name );
+}
+
+static void broker_release_control( int client )
+{
+    int controller = client;
+
+    if ( atomic_compare_exchange_strong( &global_region->controller, &controller, BROKER_NO_CLIENT ) )
+    {
+        // Nobody is left steering the vehicle
+        if ( oscc_disable( ) != OSCC_OK )
+        {
+            printf( "Error: could not disable modules after client %d left\n", client );
+        }
+    }
+}
+
+// A client holding control keeps it while it keeps commanding, unless one of
+// higher priority asks for it
+static bool broker_grant_control( int client, uint64_t now )
+{
+    broker_client_s * const clients = global_region->clients;
+
+    const int controller = atomic_load( &global_region->controller );
+
+    bool granted = false;
+
+    if ( (controller == BROKER_NO_CLIENT)
+        || (controller == client)
+        || (clients[client].priority > clients[controller].priority)
+        || ((now - atomic_load( &clients[controller].last_command_ns )) > BROKER_CONTROL_HOLD_NS) )
+    {
+        atomic_store( &global_region->controller, client );
+        atomic_store( &clients[client].last_command_ns, now );
+
+        granted = true;
+    }
+
+    return granted;
+}
+
+static void broker_apply_command( const broker_command_cell_s * const command )
+{
+    const int client = command->client;
+
+    if ( (client >= 0)
+        && (client < BROKER_CLIENTS_MAX)
+        && (atomic_load( &global_region->clients[client].pid ) != 0) )
+    {
+        broker_client_s * const slot = &global_region->clients[client];
+
+        oscc_result_t result = OSCC_OK;
+
+        atomic_fetch_add( &slot->commands, 1 );
+
+        if ( command->kind == BROKER_COMMAND_DETACH )
+        {
+            broker_release_control( client );
+
+            atomic_store( &slot->pid, 0 );
+        }
+        else
+        {
+            if ( command->kind == BROKER_COMMAND_DISABLE )
+            {
+                // Any client may stop the vehicle, whoever holds control
+                result = oscc_disable( );
+
+                atomic_store( &global_region->controller, BROKER_NO_CLIENT );
+            }
+            else if ( broker_grant_control( client, broker_now_ns( ) ) == false )
+            {
+                atomic_fetch_add( &slot->rejected, 1 );
+
+                result = OSCC_WARNING;
+            }
+            else if ( command->kind == BROKER_COMMAND_ENABLE )
+            {
+                result = oscc_enable( );
+            }
+            else
+            {
+                result = oscc_publish_commands( &command->commands );
+            }
+
+            if ( result == OSCC_ERROR )
+            {
+                printf( "Error: could not apply command from client %d\n", client );
+            }
+
+            broker_complete_command( global_region, command, result );
+        }
+    }
+}
+
+// Frees the slots of clients that exited without detaching
+static void broker_reclaim_clients( void )
+{
+    uint i;
+
+    for ( i = 0; i < BROKER_CLIENTS_MAX; i++ )
+    {
+        broker_client_s * const slot = &global_region->clients[i];
+
+        const pid_t pid = atomic_load( &slot->pid );
+
+        if ( (pid != 0) && (kill( pid, 0 ) < 0) && (errno == ESRCH) )
+        {
+            broker_release_control( (int) i );
+
+            atomic_store( &slot->pid, 0 );
+        }
+    }
+}
+
+static void broker_run( void )
+{
+    const struct timespec timeout =
+    {
+        .tv_sec = 0,
+        .tv_nsec = BROKER_IDLE_WAIT_NS
+    };
+
+    broker_command_cell_s command;
+
+    uint64_t reclaimed_ns = broker_now_ns( );
+
+    while ( global_stop == 0 )
+    {
+        const unsigned int futex = atomic_load( &global_region->command_futex );
+
+        const uint64_t now_ns = broker_now_ns( );
+
+        // A steady stream of commands must not keep a dead client in control
+        if ( (now_ns - reclaimed_ns) >= BROKER_RECLAIM_PERIOD_NS )
+        {
+            broker_reclaim_clients( );
+
+            reclaimed_ns = now_ns;
+        }
+
+        if ( broker_pop_command( global_region, &command ) )
+        {
+            broker_apply_command( &command );
+        }
+        else
+        {
+            atomic_store( &global_region->command_waiting, 1 );
+
+            broker_futex_wait( &global_region->command_futex, futex, &timeout );
+
+            atomic_store( &global_region->command_waiting, 0 );
+        }
+    }
+}
+
+static oscc_result_t broker_subscribe( void )
+{
+    const canid_t report_can_ids[] =
+    {
+        OSCC_BRAKE_REPORT_CAN_ID,
+        OSCC_THROTTLE_REPORT_CAN_ID,
+        OSCC_STEERING_REPORT_CAN_ID,
+        OSCC_FAULT_REPORT_CAN_ID
+    };
+
+    uint i;
+
+    oscc_result_t result = oscc_set_receive_mode( OSCC_RECEIVE_MODE_THREAD );
+
+    for ( i = 0; (result == OSCC_OK) && (i < (sizeof(report_can_ids) / sizeof(report_can_ids[0]))); i++ )
+    {
+        result = oscc_subscribe_to_can_id( report_can_ids[i], broker_report_handler, NULL );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        result = oscc_subscribe_to_obd_messages_timestamped( broker_obd_handler );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        // The OBD handler publishes the decoded signals with each frame
+        result = oscc_track_snapshots( );
+    }
+
+    return result;
+}
+
+static void broker_usage( const char * program )
+{
+    printf( "Usage: %s [-n name] [channel]\n", program );
+    printf( "  -n name  shared memory name, default %s\n", BROKER_NAME_DEFAULT );
+    printf( "  channel  CAN channel of the OSCC modules, detected if omitted\n" );
+}
+
+int main( int argc, char ** argv )
+{
+    const char * name = BROKER_NAME_DEFAULT;
+
+    int option;
+
+    while ( (option = getopt( argc, argv, "n:h" )) != -1 )
+    {
+        if ( option == 'n' )
+        {
+            name = optarg;
+        }
+        else
+        {
+            broker_usage( argv[0] );
+
+            return ( option == 'h' ) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    const bool detect_channel = ( optind >= argc );
+    const unsigned int channel = detect_channel ? 0 : (unsigned int) strtoul( argv[optind], NULL, 10 );
+
+    struct sigaction action;
+
+    memset( &action, 0, sizeof(action) );
+    action.sa_handler = broker_signal_handler;
+
+    sigaction( SIGINT, &action, NULL );
+    sigaction( SIGTERM, &action, NULL );
+
+    if ( (broker_create_region( name ) != OSCC_OK)
+        || (broker_subscribe( ) != OSCC_OK) )
+    {
+        printf( "Error: could not set up broker %s\n", name );
+
+        if ( global_region != NULL )
+        {
+            broker_destroy_region( name );
+        }
+
+        return EXIT_FAILURE;
+    }
+
+    oscc_result_t result = detect_channel ? oscc_init( ) : oscc_open( channel );
+
+    if ( result == OSCC_OK )
+    {
+        broker_run( );
+
+        oscc_disable( );
+        oscc_close( channel );
+    }
+    else
+    {
+        printf( "Error: could not open OSCC communications\n" );
+    }
+
+    broker_destroy_region( name );
+
+    return ( result == OSCC_OK ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
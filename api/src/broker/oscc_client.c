@@ -0,0 +1,1421 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "oscc.h"
+#include "can_protocols/brake_can_protocol.h"
+#include "can_protocols/fault_can_protocol.h"
+#include "can_protocols/magic.h"
+#include "can_protocols/steering_can_protocol.h"
+#include "can_protocols/throttle_can_protocol.h"
+#include "internal/broker.h"
+#include "internal/obd_decoder.h"
+#include "internal/snapshot.h"
+
+
+// Longest the reader thread sleeps before checking whether it should stop
+#define CLIENT_READ_WAIT_NS ( 100000000 )
+
+// One handler slot for every standard CAN ID
+#define CLIENT_CAN_ID_COUNT ( CAN_SFF_MASK + 1 )
+
+
+typedef struct
+{
+    void (*brake_report)( oscc_brake_report_s *report );
+    void (*throttle_report)( oscc_throttle_report_s *report );
+    void (*steering_report)( oscc_steering_report_s *report );
+    void (*fault_report)( oscc_fault_report_s *report );
+    void (*obd_frame)( struct can_frame *frame );
+
+    void (*brake_report_timestamped)( oscc_brake_report_s *report, const struct timespec *timestamp );
+    void (*throttle_report_timestamped)( oscc_throttle_report_s *report, const struct timespec *timestamp );
+    void (*steering_report_timestamped)( oscc_steering_report_s *report, const struct timespec *timestamp );
+    void (*fault_report_timestamped)( oscc_fault_report_s *report, const struct timespec *timestamp );
+    void (*obd_frame_timestamped)( struct can_frame *frame, const struct timespec *timestamp );
+} client_callbacks_s;
+
+typedef struct
+{
+    oscc_can_id_handler_t handler;
+    void * user_data;
+} client_subscription_s;
+
+typedef struct
+{
+    canid_t ids[OSCC_OBD_FILTER_SIZE_MAX];
+    unsigned int size;
+    bool enabled;
+} client_obd_filter_s;
+
+// Written under subscribe_lock, read by the reader thread
+typedef struct
+{
+    seqlock_s lock;
+    client_subscription_s subscription;
+} client_subscription_slot_s;
+
+typedef struct
+{
+    seqlock_s lock;
+    client_obd_filter_s filter;
+} client_obd_filter_slot_s;
+
+typedef struct
+{
+    atomic_bool busy; // A confirmed enable or disable is in progress
+    atomic_bool waiting;
+    atomic_bool target;
+    atomic_uint_fast64_t confirmed_ns[OSCC_REPORT_STREAM_COUNT];
+    atomic_uint futex; // Bumped with every stream confirmed
+} client_confirmation_s;
+
+typedef struct
+{
+    broker_region_s * region;
+    int slot; // Index of the claimed client slot
+    pthread_mutex_t send_lock; // One command of the process waits at a time
+    uint32_t ticket; // Of the latest command sent
+    pthread_t reader_thread;
+    atomic_bool reading;
+    client_callbacks_s callbacks;
+    pthread_mutex_t subscribe_lock;
+    client_subscription_slot_s subscriptions[CLIENT_CAN_ID_COUNT];
+    client_obd_filter_slot_s obd_filter;
+    client_confirmation_s confirmation;
+    const obd_vehicle_s * obd_vehicle; // Decodes frames passed to the OBD functions
+    brake_snapshot_slot_s brake;
+    steering_snapshot_slot_s steering;
+    throttle_snapshot_slot_s throttle;
+    fault_snapshot_slot_s fault;
+    obd_snapshot_slot_s obd; // Latest decoded signals the broker sent
+} client_s;
+
+
+static client_s global_client =
+{
+    .region = NULL,
+    .slot = BROKER_NO_CLIENT,
+    .send_lock = PTHREAD_MUTEX_INITIALIZER,
+    .subscribe_lock = PTHREAD_MUTEX_INITIALIZER,
+    .obd_vehicle = &OBD_VEHICLE_DEFAULT
+};
+
+static const obd_vehicle_s * const global_obd_vehicles[OSCC_VEHICLE_COUNT] =
+{
+    [OSCC_VEHICLE_KIA_SOUL] = &obd_vehicle_kia_soul,
+    [OSCC_VEHICLE_KIA_SOUL_EV] = &obd_vehicle_kia_soul_ev,
+    [OSCC_VEHICLE_KIA_NIRO] = &obd_vehicle_kia_niro
+};
+
+
+// Runs on the reader thread for each report showing a module's state
+static void client_confirm_report( oscc_report_stream_t stream, bool enabled )
+{
+    client_confirmation_s * const pending = &global_client.confirmation;
+
+    if ( (atomic_load_explicit( &pending->waiting, memory_order_relaxed ) == true)
+        && (atomic_load( &pending->target ) == enabled)
+        && (atomic_load_explicit( &pending->confirmed_ns[stream], memory_order_relaxed ) == 0) )
+    {
+        uint_fast64_t expected = 0;
+
+        // Only the first report showing the state counts
+        if ( atomic_compare_exchange_strong( &pending->confirmed_ns[stream], &expected, broker_now_ns( ) ) )
+        {
+            atomic_fetch_add( &pending->futex, 1 );
+
+            broker_futex_wake( &pending->futex );
+        }
+    }
+}
+
+static bool client_obd_frame_wanted( canid_t can_id )
+{
+    client_obd_filter_s filter;
+
+    bool wanted = true;
+
+    unsigned int i;
+
+    seqlock_read( &global_client.obd_filter.lock, &filter, &global_client.obd_filter.filter, sizeof(filter) );
+
+    if ( filter.enabled == true )
+    {
+        wanted = false;
+
+        for ( i = 0; (wanted == false) && (i < filter.size); i++ )
+        {
+            wanted = ( filter.ids[i] == can_id );
+        }
+    }
+
+    return wanted;
+}
+
+static void client_deliver( broker_frame_slot_s * const slot )
+{
+    const client_callbacks_s * const callbacks = &global_client.callbacks;
+
+    struct can_frame * const frame = &slot->frame;
+    const struct timespec * const timestamp = &slot->timestamp;
+
+    if ( slot->kind == BROKER_FRAME_OBD )
+    {
+        seqlock_write( &global_client.obd.lock, &global_client.obd.snapshot, &slot->obd, sizeof(slot->obd) );
+
+        if ( client_obd_frame_wanted( frame->can_id ) == true )
+        {
+            if ( callbacks->obd_frame != NULL )
+            {
+                callbacks->obd_frame( frame );
+            }
+
+            if ( callbacks->obd_frame_timestamped != NULL )
+            {
+                callbacks->obd_frame_timestamped( frame, timestamp );
+            }
+        }
+    }
+    else if ( (frame->data[0] == OSCC_MAGIC_BYTE_0)
+        && (frame->data[1] == OSCC_MAGIC_BYTE_1) )
+    {
+        if ( frame->can_id == OSCC_BRAKE_REPORT_CAN_ID )
+        {
+            oscc_brake_report_s * const report = ( oscc_brake_report_s * ) frame->data;
+
+            // Only the reader thread writes, so the current sequence can be
+            // read without the lock
+            const oscc_brake_report_snapshot_s snapshot =
+            {
+                .report = *report,
+                .timestamp = *timestamp,
+                .sequence = global_client.brake.snapshot.sequence + 1
+            };
+
+            seqlock_write( &global_client.brake.lock, &global_client.brake.snapshot, &snapshot, sizeof(snapshot) );
+
+            client_confirm_report( OSCC_REPORT_STREAM_BRAKE, report->enabled != 0 );
+
+            if ( callbacks->brake_report != NULL )
+            {
+                callbacks->brake_report( report );
+            }
+
+            if ( callbacks->brake_report_timestamped != NULL )
+            {
+                callbacks->brake_report_timestamped( report, timestamp );
+            }
+        }
+        else if ( frame->can_id == OSCC_THROTTLE_REPORT_CAN_ID )
+        {
+            oscc_throttle_report_s * const report = ( oscc_throttle_report_s * ) frame->data;
+
+            const oscc_throttle_report_snapshot_s snapshot =
+            {
+                .report = *report,
+                .timestamp = *timestamp,
+                .sequence = global_client.throttle.snapshot.sequence + 1
+            };
+
+            seqlock_write( &global_client.throttle.lock, &global_client.throttle.snapshot, &snapshot, sizeof(snapshot) );
+
+            client_confirm_report( OSCC_REPORT_STREAM_THROTTLE, report->enabled != 0 );
+
+            if ( callbacks->throttle_report != NULL )
+            {
+                callbacks->throttle_report( report );
+            }
+
+            if ( callbacks->throttle_report_timestamped != NULL )
+            {
+                callbacks->throttle_report_timestamped( report, timestamp );
+            }
+        }
+        else if ( frame->can_id == OSCC_STEERING_REPORT_CAN_ID )
+        {
+            oscc_steering_report_s * const report = ( oscc_steering_report_s * ) frame->data;
+
+            const oscc_steering_report_snapshot_s snapshot =
+            {
+                .report = *report,
+                .timestamp = *timestamp,
+                .sequence = global_client.steering.snapshot.sequence + 1
+            };
+
+            seqlock_write( &global_client.steering.lock, &global_client.steering.snapshot, &snapshot, sizeof(snapshot) );
+
+            client_confirm_report( OSCC_REPORT_STREAM_STEERING, report->enabled != 0 );
+
+            if ( callbacks->steering_report != NULL )
+            {
+                callbacks->steering_report( report );
+            }
+
+            if ( callbacks->steering_report_timestamped != NULL )
+            {
+                callbacks->steering_report_timestamped( report, timestamp );
+            }
+        }
+        else if ( frame->can_id == OSCC_FAULT_REPORT_CAN_ID )
+        {
+            oscc_fault_report_s * const report = ( oscc_fault_report_s * ) frame->data;
+
+            const oscc_fault_report_snapshot_s snapshot =
+            {
+                .report = *report,
+                .timestamp = *timestamp,
+                .sequence = global_client.fault.snapshot.sequence + 1
+            };
+
+            seqlock_write( &global_client.fault.lock, &global_client.fault.snapshot, &snapshot, sizeof(snapshot) );
+
+            if ( callbacks->fault_report != NULL )
+            {
+                callbacks->fault_report( report );
+            }
+
+            if ( callbacks->fault_report_timestamped != NULL )
+            {
+                callbacks->fault_report_timestamped( report, timestamp );
+            }
+        }
+    }
+
+    if ( (frame->can_id & CAN_EFF_FLAG) == 0 )
+    {
+        const client_subscription_slot_s * const entry =
+            &global_client.subscriptions[frame->can_id & CAN_SFF_MASK];
+
+        client_subscription_s subscription;
+
+        seqlock_read( &entry->lock, &subscription, &entry->subscription, sizeof(subscription) );
+
+        if ( subscription.handler != NULL )
+        {
+            subscription.handler( frame, timestamp, subscription.user_data );
+        }
+    }
+}
+
+// Follows the frame ring from the frames published after attaching. A reader
+// the broker laps skips to the oldest frame still in the ring.
+static void * client_reader_thread( void * arg )
+{
+    broker_region_s * const region = arg;
+
+    const struct timespec timeout =
+    {
+        .tv_sec = 0,
+        .tv_nsec = CLIENT_READ_WAIT_NS
+    };
+
+    uint64_t position = atomic_load_explicit( &region->frame_head, memory_order_acquire );
+
+    broker_frame_slot_s slot;
+
+    while ( atomic_load_explicit( &global_client.reading, memory_order_relaxed ) )
+    {
+        const unsigned int futex = atomic_load_explicit( &region->frame_futex, memory_order_acquire );
+        const uint64_t head = atomic_load_explicit( &region->frame_head, memory_order_acquire );
+
+        if ( position == head )
+        {
+            atomic_fetch_add( &region->frame_waiters, 1 );
+
+            broker_futex_wait( &region->frame_futex, futex, &timeout );
+
+            atomic_fetch_sub( &region->frame_waiters, 1 );
+        }
+        else if ( ((head - position) <= BROKER_FRAME_RING_SIZE)
+            && broker_read_frame( region, position, &slot ) )
+        {
+            client_deliver( &slot );
+
+            position++;
+        }
+        else
+        {
+            // Leave a slot of room for the one the broker is writing
+            position = head - BROKER_FRAME_RING_SIZE + 1;
+        }
+    }
+
+    return NULL;
+}
+
+static oscc_result_t client_attach( broker_region_s * const region )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    const pid_t pid = getpid( );
+
+    const char * const priority = getenv( "OSCC_CLIENT_PRIORITY" );
+
+    uint i;
+
+    for ( i = 0; (result != OSCC_OK) && (i < BROKER_CLIENTS_MAX); i++ )
+    {
+        broker_client_s * const slot = &region->clients[i];
+
+        int free_pid = 0;
+
+        if ( atomic_compare_exchange_strong( &slot->pid, &free_pid, pid ) )
+        {
+            slot->priority = ( priority != NULL ) ? (int32_t) strtol( priority, NULL, 10 ) : 0;
+
+            atomic_store( &slot->last_command_ns, 0 );
+            atomic_store( &slot->commands, 0 );
+            atomic_store( &slot->rejected, 0 );
+            atomic_store( &slot->completed, global_client.ticket );
+
+            global_client.slot = (int) i;
+
+            result = OSCC_OK;
+        }
+    }
+
+    if ( result != OSCC_OK )
+    {
+        printf( "Error: broker has no free client slots\n" );
+    }
+
+
+    return result;
+}
+
+static oscc_result_t client_open( void )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    const char * name = getenv( "OSCC_BROKER" );
+
+    if ( name == NULL )
+    {
+        name = BROKER_NAME_DEFAULT;
+    }
+
+    if ( global_client.region != NULL )
+    {
+        printf( "Error: already attached to broker\n" );
+    }
+    else
+    {
+        int fd = shm_open( name, O_RDWR, 0 );
+
+        struct stat status;
+
+        if ( fd < 0 )
+        {
+            perror( "shm_open failed:" );
+        }
+        else if ( fstat( fd, &status ) < 0 )
+        {
+            perror( "fstat failed:" );
+
+            close( fd );
+        }
+        else if ( status.st_size != (off_t) sizeof(broker_region_s) )
+        {
+            printf( "Error: broker %s has an incompatible layout\n", name );
+
+            close( fd );
+        }
+        else
+        {
+            void * const mapping = mmap(
+                NULL,
+                sizeof(broker_region_s),
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED,
+                fd,
+                0 );
+
+            close( fd );
+
+            if ( mapping == MAP_FAILED )
+            {
+                perror( "mmap failed:" );
+            }
+            else
+            {
+                broker_region_s * const region = mapping;
+
+                const pid_t broker_pid = atomic_load( &region->broker_pid );
+
+                if ( (region->magic != BROKER_MAGIC)
+                    || (region->version != BROKER_VERSION)
+                    || (region->size != sizeof(broker_region_s))
+                    || (broker_pid == 0)
+                    || ((kill( broker_pid, 0 ) < 0) && (errno == ESRCH)) )
+                {
+                    printf( "Error: broker %s is not running\n", name );
+                }
+                else if ( client_attach( region ) == OSCC_OK )
+                {
+                    atomic_store( &global_client.reading, true );
+
+                    if ( pthread_create( &global_client.reader_thread, NULL, client_reader_thread, region ) != 0 )
+                    {
+                        perror( "pthread_create failed:" );
+
+                        atomic_store( &global_client.reading, false );
+                        atomic_store( &region->clients[global_client.slot].pid, 0 );
+                        global_client.slot = BROKER_NO_CLIENT;
+                    }
+                    else
+                    {
+                        global_client.region = region;
+
+                        result = OSCC_OK;
+                    }
+                }
+
+                if ( result != OSCC_OK )
+                {
+                    munmap( mapping, sizeof(broker_region_s) );
+                }
+            }
+        }
+    }
+
+
+    return result;
+}
+
+// Waits for the broker to apply the command with the given ticket
+static oscc_result_t client_wait_for_result( uint32_t ticket )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    broker_client_s * const slot = &global_client.region->clients[global_client.slot];
+
+    const uint64_t deadline_ns = broker_now_ns( ) + BROKER_COMMAND_TIMEOUT_NS;
+
+    for ( ;; )
+    {
+        const unsigned int completed = atomic_load_explicit( &slot->completed, memory_order_acquire );
+
+        const uint64_t now_ns = broker_now_ns( );
+
+        if ( completed == ticket )
+        {
+            result = atomic_load_explicit( &slot->result, memory_order_relaxed );
+
+            break;
+        }
+        else if ( now_ns >= deadline_ns )
+        {
+            printf( "Error: broker did not apply command in time\n" );
+
+            break;
+        }
+
+        const struct timespec timeout =
+        {
+            .tv_sec = ( deadline_ns - now_ns ) / UINT64_C(1000000000),
+            .tv_nsec = ( deadline_ns - now_ns ) % UINT64_C(1000000000)
+        };
+
+        broker_futex_wait( &slot->completed, completed, &timeout );
+    }
+
+
+    return result;
+}
+
+static oscc_result_t client_send(
+    broker_command_kind_t kind,
+    const oscc_command_set_s * const commands )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    pthread_mutex_lock( &global_client.send_lock );
+
+    if ( global_client.region != NULL )
+    {
+        const uint32_t ticket = ++global_client.ticket;
+
+        if ( broker_push_command( global_client.region, kind, global_client.slot, ticket, commands ) )
+        {
+            result = client_wait_for_result( ticket );
+        }
+        else
+        {
+            printf( "Error: broker command queue is full\n" );
+        }
+    }
+
+    pthread_mutex_unlock( &global_client.send_lock );
+
+
+    return result;
+}
+
+// Sends an enable or disable and waits for the reports the broker forwards
+// to show every module in the requested state
+static oscc_result_t client_confirm_state_change(
+    bool enable,
+    unsigned int timeout_ms,
+    oscc_confirmation_s * const confirmation )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    client_confirmation_s * const pending = &global_client.confirmation;
+
+    bool expected = false;
+
+    if ( (confirmation == NULL)
+        || (atomic_compare_exchange_strong( &pending->busy, &expected, true ) == false) )
+    {
+        return result;
+    }
+
+    memset( confirmation, 0, sizeof(*confirmation) );
+
+    uint i;
+
+    for ( i = 0; i < OSCC_REPORT_STREAM_COUNT; i++ )
+    {
+        atomic_store( &pending->confirmed_ns[i], 0 );
+    }
+
+    atomic_store( &pending->target, enable );
+
+    const uint64_t sent_ns = broker_now_ns( );
+    const uint64_t deadline_ns = sent_ns + ( (uint64_t) timeout_ms * UINT64_C(1000000) );
+
+    // Reports read from here on are matched, so none sent in reply to the
+    // command can be missed
+    atomic_store( &pending->waiting, true );
+
+    result = client_send( enable ? BROKER_COMMAND_ENABLE : BROKER_COMMAND_DISABLE, NULL );
+
+    while ( result == OSCC_OK )
+    {
+        const unsigned int futex = atomic_load( &pending->futex );
+
+        unsigned int confirmed = 0;
+
+        for ( i = 0; i < OSCC_REPORT_STREAM_COUNT; i++ )
+        {
+            const uint64_t confirmed_ns = atomic_load( &pending->confirmed_ns[i] );
+
+            if ( confirmed_ns != 0 )
+            {
+                confirmation->confirmed[i] = true;
+                confirmation->latency_ns[i] = confirmed_ns - sent_ns;
+                confirmed++;
+            }
+        }
+
+        const uint64_t now_ns = broker_now_ns( );
+
+        if ( confirmed == OSCC_REPORT_STREAM_COUNT )
+        {
+            break;
+        }
+        else if ( now_ns >= deadline_ns )
+        {
+            result = OSCC_WARNING;
+
+            break;
+        }
+
+        const struct timespec timeout =
+        {
+            .tv_sec = ( deadline_ns - now_ns ) / UINT64_C(1000000000),
+            .tv_nsec = ( deadline_ns - now_ns ) % UINT64_C(1000000000)
+        };
+
+        broker_futex_wait( &pending->futex, futex, &timeout );
+    }
+
+    atomic_store( &pending->waiting, false );
+    atomic_store( &pending->busy, false );
+
+    return result;
+}
+
+static oscc_result_t client_get_obd_signal(
+    const struct can_frame * const frame,
+    oscc_obd_signal_t signal,
+    double * const value )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    const obd_vehicle_s * const obd_vehicle = global_client.obd_vehicle;
+
+    double values[OSCC_OBD_SIGNAL_COUNT];
+
+    if ( (frame != NULL)
+        && (value != NULL)
+        && (obd_frame_carries( obd_vehicle, frame->can_id, signal ) == true) )
+    {
+        (void) obd_frame_decode( obd_vehicle_frame( obd_vehicle, frame->can_id ), frame, values );
+
+        *value = values[signal];
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+
+oscc_result_t oscc_init( )
+{
+    return client_open( );
+}
+
+oscc_result_t oscc_open( unsigned int channel )
+{
+    // The broker owns the channel, it was chosen when the broker started
+    (void) channel;
+
+    return client_open( );
+}
+
+oscc_result_t oscc_close( unsigned int channel )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    (void) channel;
+
+    broker_region_s * const region = global_client.region;
+
+    if ( region != NULL )
+    {
+        atomic_store( &global_client.reading, false );
+
+        pthread_join( global_client.reader_thread, NULL );
+
+        // Commands from other threads finish waiting before the region goes
+        pthread_mutex_lock( &global_client.send_lock );
+
+        // The broker frees the slot once it has handed back any control held,
+        // or finds this process gone if the queue is full
+        broker_push_command( region, BROKER_COMMAND_DETACH, global_client.slot, 0, NULL );
+
+        munmap( region, sizeof(broker_region_s) );
+
+        global_client.region = NULL;
+        global_client.slot = BROKER_NO_CLIENT;
+
+        pthread_mutex_unlock( &global_client.send_lock );
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_enable( void )
+{
+    return client_send( BROKER_COMMAND_ENABLE, NULL );
+}
+
+oscc_result_t oscc_disable( void )
+{
+    return client_send( BROKER_COMMAND_DISABLE, NULL );
+}
+
+oscc_result_t oscc_enable_confirmed(
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation )
+{
+    return client_confirm_state_change( true, timeout_ms, confirmation );
+}
+
+oscc_result_t oscc_disable_confirmed(
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation )
+{
+    return client_confirm_state_change( false, timeout_ms, confirmation );
+}
+
+oscc_result_t oscc_publish_brake_position( double brake_position )
+{
+    const oscc_command_set_s commands =
+    {
+        .publish_brake = true,
+        .brake_position = brake_position
+    };
+
+    return client_send( BROKER_COMMAND_PUBLISH, &commands );
+}
+
+oscc_result_t oscc_publish_throttle_position( double throttle_position )
+{
+    const oscc_command_set_s commands =
+    {
+        .publish_throttle = true,
+        .throttle_position = throttle_position
+    };
+
+    return client_send( BROKER_COMMAND_PUBLISH, &commands );
+}
+
+oscc_result_t oscc_publish_steering_torque( double torque )
+{
+    const oscc_command_set_s commands =
+    {
+        .publish_steering = true,
+        .steering_torque = torque
+    };
+
+    return client_send( BROKER_COMMAND_PUBLISH, &commands );
+}
+
+oscc_result_t oscc_publish_commands( const oscc_command_set_s * commands )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( commands != NULL )
+    {
+        result = client_send( BROKER_COMMAND_PUBLISH, commands );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_brake_reports( void( *callback )( oscc_brake_report_s *report ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.brake_report = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_throttle_reports( void( *callback )( oscc_throttle_report_s *report ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.throttle_report = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_steering_reports( void( *callback )( oscc_steering_report_s *report ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.steering_report = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_fault_reports( void( *callback )( oscc_fault_report_s *report ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.fault_report = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_obd_messages( void( *callback )( struct can_frame *frame ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.obd_frame = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_brake_reports_timestamped(
+    void( *callback )( oscc_brake_report_s *report, const struct timespec *timestamp ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.brake_report_timestamped = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_throttle_reports_timestamped(
+    void( *callback )( oscc_throttle_report_s *report, const struct timespec *timestamp ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.throttle_report_timestamped = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_steering_reports_timestamped(
+    void( *callback )( oscc_steering_report_s *report, const struct timespec *timestamp ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.steering_report_timestamped = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_fault_reports_timestamped(
+    void( *callback )( oscc_fault_report_s *report, const struct timespec *timestamp ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.fault_report_timestamped = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_obd_messages_timestamped(
+    void( *callback )( struct can_frame *frame, const struct timespec *timestamp ) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( callback != NULL )
+    {
+        global_client.callbacks.obd_frame_timestamped = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_get_latest_obd_values( oscc_obd_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( snapshot != NULL )
+    {
+        seqlock_read( &global_client.obd.lock, snapshot, &global_client.obd.snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_subscribe_to_can_id(
+    canid_t can_id,
+    oscc_can_id_handler_t handler,
+    void * user_data )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( can_id < CLIENT_CAN_ID_COUNT )
+    {
+        client_subscription_slot_s * const entry = &global_client.subscriptions[can_id];
+
+        const client_subscription_s subscription =
+        {
+            .handler = handler,
+            .user_data = user_data
+        };
+
+        // The reader thread must never pair a handler with the user data of
+        // another subscription
+        pthread_mutex_lock( &global_client.subscribe_lock );
+
+        seqlock_write( &entry->lock, &entry->subscription, &subscription, sizeof(subscription) );
+
+        pthread_mutex_unlock( &global_client.subscribe_lock );
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_set_obd_message_filter( const canid_t * can_ids, unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (can_ids == NULL) || (count <= OSCC_OBD_FILTER_SIZE_MAX) )
+    {
+        client_obd_filter_s filter;
+
+        memset( &filter, 0, sizeof(filter) );
+
+        if ( can_ids != NULL )
+        {
+            memcpy( filter.ids, can_ids, count * sizeof(can_ids[0]) );
+            filter.size = count;
+            filter.enabled = true;
+        }
+
+        // The broker forwards every OBD message, so the callbacks are what
+        // the filter narrows
+        pthread_mutex_lock( &global_client.subscribe_lock );
+
+        seqlock_write( &global_client.obd_filter.lock, &global_client.obd_filter.filter, &filter, sizeof(filter) );
+
+        pthread_mutex_unlock( &global_client.subscribe_lock );
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_track_snapshots( void )
+{
+    // Every report and OBD message the broker forwards updates the snapshots
+    return OSCC_OK;
+}
+
+oscc_result_t oscc_get_latest_brake_report( oscc_brake_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( snapshot != NULL )
+    {
+        seqlock_read( &global_client.brake.lock, snapshot, &global_client.brake.snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_get_latest_steering_report( oscc_steering_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( snapshot != NULL )
+    {
+        seqlock_read( &global_client.steering.lock, snapshot, &global_client.steering.snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_get_latest_throttle_report( oscc_throttle_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( snapshot != NULL )
+    {
+        seqlock_read( &global_client.throttle.lock, snapshot, &global_client.throttle.snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_get_latest_fault_report( oscc_fault_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( snapshot != NULL )
+    {
+        seqlock_read( &global_client.fault.lock, snapshot, &global_client.fault.snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_set_vehicle( oscc_vehicle_t vehicle )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( ((unsigned int) vehicle < OSCC_VEHICLE_COUNT) && (global_client.region == NULL) )
+    {
+        global_client.obd_vehicle = global_obd_vehicles[vehicle];
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_decode_obd_frame(
+    const struct can_frame * frame,
+    double * values,
+    unsigned int * decoded )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (frame != NULL) && (values != NULL) && (decoded != NULL) )
+    {
+        const obd_frame_s * const obd_frame =
+            obd_vehicle_frame( global_client.obd_vehicle, frame->can_id );
+
+        if ( obd_frame != NULL )
+        {
+            *decoded = obd_frame_decode( obd_frame, frame, values );
+            result = OSCC_OK;
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_decode_wheel_speeds(
+    const struct can_frame * frame,
+    double * wheel_speeds )
+{
+    return oscc_decode_wheel_speeds_array( frame, 1, wheel_speeds );
+}
+
+oscc_result_t oscc_decode_wheel_speeds_array(
+    const struct can_frame * frames,
+    size_t count,
+    double * wheel_speeds )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (frames != NULL) && (wheel_speeds != NULL) )
+    {
+        const obd_frame_s * const obd_frame = obd_vehicle_signal_frame(
+            global_client.obd_vehicle,
+            OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT );
+
+        size_t i;
+
+        for ( i = 0; (obd_frame != NULL) && (i < count); i++ )
+        {
+            if ( frames[i].can_id != obd_frame->can_id )
+            {
+                break;
+            }
+        }
+
+        if ( (obd_frame != NULL) && (i == count) )
+        {
+            obd_frames_decode_wheel_speeds( obd_frame, frames, count, wheel_speeds );
+            result = OSCC_OK;
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t get_wheel_speed_right_rear(
+    struct can_frame const * const frame,
+    double * wheel_speed_right_rear )
+{
+    return client_get_obd_signal( frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_REAR, wheel_speed_right_rear );
+}
+
+oscc_result_t get_wheel_speed_left_rear(
+    struct can_frame const * const frame,
+    double * wheel_speed_left_rear )
+{
+    return client_get_obd_signal( frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_REAR, wheel_speed_left_rear );
+}
+
+oscc_result_t get_wheel_speed_right_front(
+    struct can_frame const * const frame,
+    double * wheel_speed_right_front )
+{
+    return client_get_obd_signal( frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_FRONT, wheel_speed_right_front );
+}
+
+oscc_result_t get_wheel_speed_left_front(
+    struct can_frame const * const frame,
+    double * wheel_speed_left_front )
+{
+    return client_get_obd_signal( frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT, wheel_speed_left_front );
+}
+
+oscc_result_t get_steering_wheel_angle(
+    struct can_frame const * const frame,
+    double * steering_wheel_angle )
+{
+    return client_get_obd_signal( frame, OSCC_OBD_SIGNAL_STEERING_WHEEL_ANGLE, steering_wheel_angle );
+}
+
+oscc_result_t get_brake_pressure(
+    struct can_frame const * const frame,
+    double * brake_pressure )
+{
+    return client_get_obd_signal( frame, OSCC_OBD_SIGNAL_BRAKE_PRESSURE, brake_pressure );
+}
+
+
+/*
+ * The broker alone receives, transmits and watches the buses, so what
+ * follows has nothing to act on in a client. The functions fail rather than
+ * leave programs using them unable to link.
+ */
+oscc_result_t oscc_set_report_watchdog( double period_multiple, bool auto_disable )
+{
+    (void) period_multiple;
+    (void) auto_disable;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_subscribe_to_stale_reports( void (*callback)(oscc_report_stream_t stream) )
+{
+    (void) callback;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_set_receive_mode( oscc_receive_mode_t mode )
+{
+    (void) mode;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_fds( int * fds, unsigned int * count )
+{
+    (void) fds;
+    (void) count;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_process_pending(
+    unsigned int max_frames,
+    unsigned int * frames_processed )
+{
+    (void) max_frames;
+    (void) frames_processed;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_set_receive_batch_size( unsigned int size )
+{
+    (void) size;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_receive_counters( oscc_receive_counters_s * counters )
+{
+    (void) counters;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_can_id_counters(
+    oscc_can_bus_t bus,
+    canid_t can_id,
+    oscc_can_id_counters_s * counters )
+{
+    (void) bus;
+    (void) can_id;
+    (void) counters;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_bus_stats( oscc_can_bus_t bus, oscc_bus_stats_s * stats )
+{
+    (void) bus;
+    (void) stats;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_start_recording( const char * path )
+{
+    (void) path;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_stop_recording( void )
+{
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_replay( const char * path, double speed )
+{
+    (void) path;
+    (void) speed;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_set_transmit_rate( unsigned int rate )
+{
+    (void) rate;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_flush_commands( void )
+{
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_priority_latency( oscc_priority_latency_s * latency )
+{
+    (void) latency;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_stats( oscc_stats_s * stats )
+{
+    (void) stats;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_reset_stats( void )
+{
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_set_stats_bounds( const uint64_t * bounds_ns, unsigned int count )
+{
+    (void) bounds_ns;
+    (void) count;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_print_stats( FILE * stream )
+{
+    (void) stream;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_receive_threads(
+    pthread_t * receive_thread,
+    pthread_t * dispatch_thread )
+{
+    (void) receive_thread;
+    (void) dispatch_thread;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_set_receive_realtime(
+    int priority,
+    int cpu,
+    bool lock_memory )
+{
+    (void) priority;
+    (void) cpu;
+    (void) lock_memory;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_set_io_backend( oscc_io_backend_t backend )
+{
+    (void) backend;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_get_io_backend( oscc_io_backend_t * backend )
+{
+    (void) backend;
+
+    return OSCC_ERROR;
+}
+
+oscc_result_t oscc_set_busy_poll( const oscc_busy_poll_s * busy_poll )
+{
+    (void) busy_poll;
+
+    return OSCC_ERROR;
+}
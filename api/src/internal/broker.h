@@ -0,0 +1,353 @@
+/**
+ * @file internal/broker.h
+ * @brief Shared memory layout connecting oscc-broker to its clients: a ring
+ *        of received frames every client reads, and a ring of commands every
+ *        client writes into and the broker alone reads.
+ */
+
+
+#ifndef _OSCC_BROKER_H
+#define _OSCC_BROKER_H
+
+#include <errno.h>
+#include <linux/can.h>
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oscc.h"
+
+
+/*
+ * @brief Identifies a mapped broker region, "OSCB".
+ *
+ */
+#define BROKER_MAGIC ( 0x4243534F )
+
+/*
+ * @brief Changes whenever the layout of \ref broker_region_s does, so a
+ * client never talks to a broker built from an incompatible library.
+ *
+ */
+#define BROKER_VERSION ( 1 )
+
+/*
+ * @brief Name the broker and its clients use unless OSCC_BROKER in the
+ * environment gives another.
+ *
+ */
+#define BROKER_NAME_DEFAULT "/oscc-broker"
+
+/*
+ * @brief Received frames kept in the ring. A client that falls further
+ * behind than this skips ahead and loses the frames in between. Must be a
+ * power of two.
+ *
+ */
+#define BROKER_FRAME_RING_SIZE ( 4096 )
+
+/*
+ * @brief Commands waiting for the broker. Must be a power of two.
+ *
+ */
+#define BROKER_COMMAND_RING_SIZE ( 256 )
+
+/*
+ * @brief Clients attached at once.
+ *
+ */
+#define BROKER_CLIENTS_MAX ( 16 )
+
+/*
+ * @brief Time after its latest command a client keeps control against clients
+ * of the same or lower priority.
+ *
+ */
+#define BROKER_CONTROL_HOLD_NS ( UINT64_C(200000000) )
+
+/*
+ * @brief Longest a client waits for the broker to apply one of its commands.
+ *
+ */
+#define BROKER_COMMAND_TIMEOUT_NS ( UINT64_C(100000000) )
+
+/*
+ * @brief Assumed size of a cache line, used to keep the rings' indices and
+ * slots from sharing one.
+ *
+ */
+#define BROKER_CACHE_LINE ( 64 )
+
+// No client holds control
+#define BROKER_NO_CLIENT ( -1 )
+
+
+typedef enum
+{
+    BROKER_FRAME_REPORT,
+    BROKER_FRAME_OBD
+} broker_frame_kind_t;
+
+typedef enum
+{
+    BROKER_COMMAND_ENABLE,
+    BROKER_COMMAND_DISABLE,
+    BROKER_COMMAND_PUBLISH,
+    BROKER_COMMAND_DETACH // The client is done and frees its slot
+} broker_command_kind_t;
+
+// The sequence is odd while the broker writes the slot and 2 * (position + 1)
+// once frame position is in it, so readers detect both torn and lapped slots
+typedef struct
+{
+    _Alignas( BROKER_CACHE_LINE ) atomic_uint_fast64_t sequence;
+    uint32_t kind; // broker_frame_kind_t
+    uint32_t reserved;
+    struct can_frame frame;
+    struct timespec timestamp;
+    oscc_obd_snapshot_s obd; // Decoded signals after an OBD frame
+} broker_frame_slot_s;
+
+// The sequence equals the position a producer may claim the cell for, and
+// position + 1 once the command in it is complete
+typedef struct
+{
+    _Alignas( BROKER_CACHE_LINE ) atomic_uint_fast64_t sequence;
+    uint32_t kind; // broker_command_kind_t
+    int32_t client;
+    uint32_t ticket; // Numbers the client's commands, see broker_client_s
+    oscc_command_set_s commands;
+} broker_command_cell_s;
+
+typedef struct
+{
+    _Alignas( BROKER_CACHE_LINE ) atomic_int pid; // Zero while the slot is free
+    int32_t priority;
+    atomic_uint_fast64_t last_command_ns; // CLOCK_MONOTONIC
+    atomic_uint_fast64_t commands;
+    atomic_uint_fast64_t rejected; // Commands sent without holding control
+    atomic_uint completed; // Ticket of the latest command applied, a futex
+    atomic_int result; // oscc_result_t of that command
+} broker_client_s;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    atomic_int broker_pid;
+
+    _Alignas( BROKER_CACHE_LINE ) atomic_uint_fast64_t frame_head; // Next position written
+    atomic_uint frame_futex; // Bumped after every frame
+    atomic_uint frame_waiters;
+    broker_frame_slot_s frames[BROKER_FRAME_RING_SIZE];
+
+    _Alignas( BROKER_CACHE_LINE ) atomic_uint_fast64_t command_tail; // Claimed by clients
+    _Alignas( BROKER_CACHE_LINE ) atomic_uint_fast64_t command_head; // Taken by the broker
+    atomic_uint command_futex; // Bumped after every command
+    atomic_uint command_waiting; // The broker sleeps on command_futex
+    broker_command_cell_s commands[BROKER_COMMAND_RING_SIZE];
+
+    _Alignas( BROKER_CACHE_LINE ) atomic_int controller; // Client index or BROKER_NO_CLIENT
+    broker_client_s clients[BROKER_CLIENTS_MAX];
+} broker_region_s;
+
+
+static inline uint64_t broker_now_ns( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec;
+}
+
+// Shared between processes, so the futexes are not private
+static inline void broker_futex_wait(
+    atomic_uint * const word,
+    unsigned int expected,
+    const struct timespec * const timeout )
+{
+    syscall( SYS_futex, word, FUTEX_WAIT, expected, timeout, NULL, 0 );
+}
+
+static inline void broker_futex_wake( atomic_uint * const word )
+{
+    syscall( SYS_futex, word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0 );
+}
+
+// Must only be called by the broker, from one thread
+static inline void broker_publish_frame(
+    broker_region_s * const region,
+    broker_frame_kind_t kind,
+    const struct can_frame * const frame,
+    const struct timespec * const timestamp,
+    const oscc_obd_snapshot_s * const obd )
+{
+    const uint64_t position = atomic_load_explicit( &region->frame_head, memory_order_relaxed );
+
+    broker_frame_slot_s * const slot = &region->frames[position & (BROKER_FRAME_RING_SIZE - 1)];
+
+    atomic_store_explicit( &slot->sequence, (2 * position) + 1, memory_order_relaxed );
+    atomic_thread_fence( memory_order_release );
+
+    slot->kind = kind;
+    slot->frame = *frame;
+    slot->timestamp = *timestamp;
+
+    if ( obd != NULL )
+    {
+        slot->obd = *obd;
+    }
+
+    atomic_store_explicit( &slot->sequence, 2 * (position + 1), memory_order_release );
+    atomic_store_explicit( &region->frame_head, position + 1, memory_order_release );
+
+    atomic_fetch_add_explicit( &region->frame_futex, 1, memory_order_release );
+
+    if ( atomic_load_explicit( &region->frame_waiters, memory_order_seq_cst ) > 0 )
+    {
+        broker_futex_wake( &region->frame_futex );
+    }
+}
+
+// Copies frame position into slot. Returns false if the broker has already
+// overwritten it, or is doing so.
+static inline bool broker_read_frame(
+    const broker_region_s * const region,
+    uint64_t position,
+    broker_frame_slot_s * const slot )
+{
+    const broker_frame_slot_s * const source = &region->frames[position & (BROKER_FRAME_RING_SIZE - 1)];
+
+    const uint64_t expected = 2 * ( position + 1 );
+
+    bool complete = false;
+
+    if ( atomic_load_explicit( (atomic_uint_fast64_t *) &source->sequence, memory_order_acquire ) == expected )
+    {
+        slot->kind = source->kind;
+        slot->frame = source->frame;
+        slot->timestamp = source->timestamp;
+        slot->obd = source->obd;
+
+        atomic_thread_fence( memory_order_acquire );
+
+        complete = ( atomic_load_explicit(
+            (atomic_uint_fast64_t *) &source->sequence,
+            memory_order_relaxed ) == expected );
+    }
+
+    return complete;
+}
+
+// Safe to call from any number of clients at once. Returns false if the
+// ring is full.
+static inline bool broker_push_command(
+    broker_region_s * const region,
+    broker_command_kind_t kind,
+    int client,
+    uint32_t ticket,
+    const oscc_command_set_s * const commands )
+{
+    uint64_t position = atomic_load_explicit( &region->command_tail, memory_order_relaxed );
+
+    broker_command_cell_s * cell = NULL;
+
+    for ( ;; )
+    {
+        cell = &region->commands[position & (BROKER_COMMAND_RING_SIZE - 1)];
+
+        const uint64_t sequence = atomic_load_explicit( &cell->sequence, memory_order_acquire );
+
+        if ( sequence == position )
+        {
+            if ( atomic_compare_exchange_weak_explicit(
+                    &region->command_tail, &position, position + 1,
+                    memory_order_relaxed, memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if ( sequence < position )
+        {
+            // The broker hasn't taken the command a lap ago yet
+            return false;
+        }
+        else
+        {
+            position = atomic_load_explicit( &region->command_tail, memory_order_relaxed );
+        }
+    }
+
+    cell->kind = kind;
+    cell->client = client;
+    cell->ticket = ticket;
+
+    if ( commands != NULL )
+    {
+        cell->commands = *commands;
+    }
+
+    atomic_store_explicit( &cell->sequence, position + 1, memory_order_release );
+
+    atomic_fetch_add_explicit( &region->command_futex, 1, memory_order_release );
+
+    if ( atomic_load_explicit( &region->command_waiting, memory_order_seq_cst ) != 0 )
+    {
+        broker_futex_wake( &region->command_futex );
+    }
+
+    return true;
+}
+
+// Must only be called by the broker, from one thread. Returns false if no
+// complete command is waiting.
+static inline bool broker_pop_command(
+    broker_region_s * const region,
+    broker_command_cell_s * const command )
+{
+    const uint64_t position = atomic_load_explicit( &region->command_head, memory_order_relaxed );
+
+    broker_command_cell_s * const cell = &region->commands[position & (BROKER_COMMAND_RING_SIZE - 1)];
+
+    bool popped = false;
+
+    if ( atomic_load_explicit( &cell->sequence, memory_order_acquire ) == (position + 1) )
+    {
+        command->kind = cell->kind;
+        command->client = cell->client;
+        command->ticket = cell->ticket;
+        command->commands = cell->commands;
+
+        atomic_store_explicit( &cell->sequence, position + BROKER_COMMAND_RING_SIZE, memory_order_release );
+        atomic_store_explicit( &region->command_head, position + 1, memory_order_relaxed );
+
+        popped = true;
+    }
+
+    return popped;
+}
+
+// Must only be called by the broker. Hands the client waiting on command the
+// result of applying it.
+static inline void broker_complete_command(
+    broker_region_s * const region,
+    const broker_command_cell_s * const command,
+    oscc_result_t result )
+{
+    broker_client_s * const client = &region->clients[command->client];
+
+    atomic_store_explicit( &client->result, result, memory_order_relaxed );
+    atomic_store_explicit( &client->completed, command->ticket, memory_order_release );
+
+    broker_futex_wake( &client->completed );
+}
+
+
+#endif /* _OSCC_BROKER_H */
@@ -0,0 +1,56 @@
+/**
+ * @file internal/frame_log.h
+ * @brief Layout of the append-only binary log of received frames written by
+ *        the recorder and read back by the replay engine.
+ */
+
+
+#ifndef _OSCC_FRAME_LOG_H
+#define _OSCC_FRAME_LOG_H
+
+#include <linux/can.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "oscc.h"
+
+
+/*
+ * @brief Identifies a frame log, "OSCCLOG1" read as a little-endian word.
+ *
+ */
+#define FRAME_LOG_MAGIC ( UINT64_C(0x31474F4C4343534F) )
+
+/*
+ * @brief Changes whenever the layout of \ref frame_log_record_s does, so a
+ * log is never replayed by a library that would misread it.
+ *
+ */
+#define FRAME_LOG_VERSION ( 1 )
+
+
+// Written once at the start of the file
+typedef struct
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+} frame_log_header_s;
+
+// Fixed size, so record i of a mapped log is found without parsing the rest
+typedef struct
+{
+    uint64_t timestamp_ns; // Receive timestamp as recorded by the socket
+    uint32_t bus; // oscc_can_bus_t
+    uint32_t reserved;
+    struct can_frame frame;
+} frame_log_record_s;
+
+typedef struct
+{
+    atomic_int fd; // Open for appending, or -1 while not recording
+    atomic_uint writers; // Batches being written that fd must outlive
+} frame_recorder_s;
+
+
+#endif /* _OSCC_FRAME_LOG_H */
@@ -0,0 +1,99 @@
+/**
+ * @file internal/frame_queue.h
+ * @brief Lock-free single-producer single-consumer queue of received
+ *        CAN frames.
+ */
+
+
+#ifndef _OSCC_FRAME_QUEUE_H
+#define _OSCC_FRAME_QUEUE_H
+
+#include <linux/can.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "oscc.h"
+
+
+/*
+ * @brief Number of frames the queue can hold. Must be a power of two so the
+ * free running indices can be masked into the frame array.
+ *
+ */
+#define FRAME_QUEUE_CAPACITY ( 1024 )
+
+/*
+ * @brief Assumed size of a cache line, used to keep the producer and consumer
+ * indices from sharing one.
+ *
+ */
+#define FRAME_QUEUE_CACHE_LINE ( 64 )
+
+
+typedef struct
+{
+    struct can_frame frame;
+    struct timespec timestamp;
+    oscc_can_bus_t bus;
+} oscc_rx_frame_s;
+
+typedef struct
+{
+    _Alignas( FRAME_QUEUE_CACHE_LINE ) atomic_size_t head; /* Consumer index */
+    _Alignas( FRAME_QUEUE_CACHE_LINE ) atomic_size_t tail; /* Producer index */
+    _Alignas( FRAME_QUEUE_CACHE_LINE ) oscc_rx_frame_s frames[FRAME_QUEUE_CAPACITY];
+} frame_queue_s;
+
+
+static inline void frame_queue_reset( frame_queue_s * const queue )
+{
+    atomic_store_explicit( &queue->head, 0, memory_order_relaxed );
+    atomic_store_explicit( &queue->tail, 0, memory_order_relaxed );
+}
+
+// Must only be called from the producer thread. Returns false if the queue
+// is full and the frame was not queued.
+static inline bool frame_queue_push(
+    frame_queue_s * const queue,
+    const oscc_rx_frame_s * const rx_frame )
+{
+    size_t tail = atomic_load_explicit( &queue->tail, memory_order_relaxed );
+    size_t head = atomic_load_explicit( &queue->head, memory_order_acquire );
+
+    if ( (tail - head) == FRAME_QUEUE_CAPACITY )
+    {
+        return false;
+    }
+
+    queue->frames[tail & (FRAME_QUEUE_CAPACITY - 1)] = *rx_frame;
+
+    atomic_store_explicit( &queue->tail, tail + 1, memory_order_release );
+
+    return true;
+}
+
+// Must only be called from the consumer thread. Returns false if the queue
+// is empty.
+static inline bool frame_queue_pop(
+    frame_queue_s * const queue,
+    oscc_rx_frame_s * const rx_frame )
+{
+    size_t head = atomic_load_explicit( &queue->head, memory_order_relaxed );
+    size_t tail = atomic_load_explicit( &queue->tail, memory_order_acquire );
+
+    if ( head == tail )
+    {
+        return false;
+    }
+
+    *rx_frame = queue->frames[head & (FRAME_QUEUE_CAPACITY - 1)];
+
+    atomic_store_explicit( &queue->head, head + 1, memory_order_release );
+
+    return true;
+}
+
+
+#endif /* _OSCC_FRAME_QUEUE_H */
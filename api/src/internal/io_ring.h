@@ -0,0 +1,209 @@
+/**
+ * @file internal/io_ring.h
+ * @brief Minimal io_uring plumbing for the receive engine, talking to the
+ *        kernel through raw system calls so no liburing is needed.
+ */
+
+
+#ifndef _OSCC_IO_RING_H
+#define _OSCC_IO_RING_H
+
+#include <linux/can.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "oscc.h"
+
+// Multishot recvmsg, which the backend relies on, arrived after the rest of
+// io_uring, so older headers build the epoll backend alone
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#if defined(IORING_RECV_MULTISHOT) && defined(IORING_SETUP_SINGLE_ISSUER) \
+    && defined(__NR_io_uring_setup)
+#define IO_RING_SUPPORTED
+#endif
+
+
+/*
+ * @brief Submission queue entries of each ring, enough for both sockets,
+ * the stop poll and a batch of command writes.
+ *
+ */
+#define IO_RING_ENTRIES ( 16 )
+
+/*
+ * @brief Buffers the kernel fills with received frames before the receive
+ * thread hands them back. Must be a power of two.
+ *
+ */
+#define IO_RING_BUFFER_COUNT ( 256 )
+
+/*
+ * @brief Frames the receive thread collects from completions before passing
+ * them on to the dispatch thread, no more than a receive batch can hold.
+ *
+ */
+#define IO_RING_FRAME_BATCH ( OSCC_RECEIVE_BATCH_SIZE_MAX )
+
+
+// Completion user_data values, the receive requests use their bus
+#define IO_RING_TAG_STOP ( OSCC_CAN_BUS_COUNT )
+#define IO_RING_TAG_SEND ( OSCC_CAN_BUS_COUNT + 1 )
+
+
+#ifdef IO_RING_SUPPORTED
+
+// Each buffer holds the recvmsg header, control messages and one frame,
+// RECEIVE_CONTROL_SIZE coming from internal/oscc.h
+#define IO_RING_BUFFER_SIZE \
+    ( ((sizeof(struct io_uring_recvmsg_out) + RECEIVE_CONTROL_SIZE \
+        + sizeof(struct can_frame)) + 63) & ~(size_t) 63 )
+
+typedef struct
+{
+    int fd;
+    void * mapping; // Submission and completion rings, mapped together
+    size_t mapping_size;
+    struct io_uring_sqe * sqes;
+    size_t sqes_size;
+    _Atomic unsigned int * sq_head;
+    _Atomic unsigned int * sq_tail;
+    unsigned int sq_mask;
+    unsigned int * sq_array;
+    _Atomic unsigned int * cq_head;
+    _Atomic unsigned int * cq_tail;
+    unsigned int cq_mask;
+    struct io_uring_cqe * cqes;
+    unsigned int to_submit; // Entries queued since the last io_uring_enter
+} io_ring_s;
+
+typedef struct
+{
+    io_ring_s ring;
+    struct io_uring_buf_ring * buffer_ring;
+    unsigned char * buffers;
+    size_t buffer_size;
+    size_t buffers_size; // Buffer ring and buffers, mapped together
+    struct msghdr receive_message; // Space to reserve in each buffer
+} io_ring_receiver_s;
+
+
+static inline int io_ring_setup( unsigned int entries, struct io_uring_params * const params )
+{
+    return (int) syscall( __NR_io_uring_setup, entries, params );
+}
+
+static inline int io_ring_enter(
+    const io_ring_s * const ring,
+    unsigned int to_submit,
+    unsigned int min_complete,
+    unsigned int flags )
+{
+    return (int) syscall( __NR_io_uring_enter, ring->fd, to_submit, min_complete, flags, NULL, 0 );
+}
+
+static inline int io_ring_register(
+    const io_ring_s * const ring,
+    unsigned int opcode,
+    void * const arg,
+    unsigned int count )
+{
+    return (int) syscall( __NR_io_uring_register, ring->fd, opcode, arg, count );
+}
+
+// Returns a cleared entry to fill in, or NULL if the submission queue is full
+static inline struct io_uring_sqe * io_ring_get_sqe( io_ring_s * const ring )
+{
+    struct io_uring_sqe * sqe = NULL;
+
+    const unsigned int tail = atomic_load_explicit( ring->sq_tail, memory_order_relaxed );
+    const unsigned int head = atomic_load_explicit( ring->sq_head, memory_order_acquire );
+
+    if ( (tail - head) < (ring->sq_mask + 1) )
+    {
+        const unsigned int index = tail & ring->sq_mask;
+
+        sqe = &ring->sqes[index];
+        memset( sqe, 0, sizeof(*sqe) );
+
+        ring->sq_array[index] = index;
+
+        atomic_store_explicit( ring->sq_tail, tail + 1, memory_order_release );
+
+        ring->to_submit++;
+    }
+
+    return sqe;
+}
+
+// Returns the oldest completion without consuming it, or NULL if none
+static inline struct io_uring_cqe * io_ring_peek_cqe( const io_ring_s * const ring )
+{
+    struct io_uring_cqe * cqe = NULL;
+
+    const unsigned int head = atomic_load_explicit( ring->cq_head, memory_order_relaxed );
+
+    if ( head != atomic_load_explicit( ring->cq_tail, memory_order_acquire ) )
+    {
+        cqe = &ring->cqes[head & ring->cq_mask];
+    }
+
+    return cqe;
+}
+
+static inline void io_ring_cqe_seen( const io_ring_s * const ring )
+{
+    atomic_fetch_add_explicit( ring->cq_head, 1, memory_order_release );
+}
+
+// Hands buffer id back to the kernel, visible once io_ring_buffers_publish
+// has been called
+static inline void io_ring_buffer_return(
+    io_ring_receiver_s * const receiver,
+    unsigned int id,
+    unsigned int offset )
+{
+    struct io_uring_buf_ring * const buffer_ring = receiver->buffer_ring;
+
+    const unsigned int index = ( buffer_ring->tail + offset ) & ( IO_RING_BUFFER_COUNT - 1 );
+
+    buffer_ring->bufs[index].addr = (unsigned long) ( receiver->buffers + ((size_t) id * receiver->buffer_size) );
+    buffer_ring->bufs[index].len = (unsigned int) receiver->buffer_size;
+    buffer_ring->bufs[index].bid = (unsigned short) id;
+}
+
+static inline void io_ring_buffers_publish(
+    io_ring_receiver_s * const receiver,
+    unsigned int count )
+{
+    atomic_store_explicit(
+        (_Atomic unsigned short *) &receiver->buffer_ring->tail,
+        (unsigned short) ( receiver->buffer_ring->tail + count ),
+        memory_order_release );
+}
+
+#else
+
+typedef struct
+{
+    int fd;
+} io_ring_s;
+
+typedef struct
+{
+    io_ring_s ring;
+} io_ring_receiver_s;
+
+#endif /* IO_RING_SUPPORTED */
+
+
+#endif /* _OSCC_IO_RING_H */
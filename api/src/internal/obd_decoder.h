@@ -0,0 +1,240 @@
+/**
+ * @file internal/obd_decoder.h
+ * @brief OBD signal tables generated from the vehicle headers and the
+ *        decoder that walks them.
+ */
+
+
+#ifndef _OSCC_OBD_DECODER_H
+#define _OSCC_OBD_DECODER_H
+
+#include <endian.h>
+#include <linux/can.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "obd_signals.h"
+
+
+#if defined(KIA_SOUL)
+#define OBD_VEHICLE_DEFAULT ( obd_vehicle_kia_soul )
+#elif defined(KIA_SOUL_EV)
+#define OBD_VEHICLE_DEFAULT ( obd_vehicle_kia_soul_ev )
+#elif defined(KIA_NIRO)
+#define OBD_VEHICLE_DEFAULT ( obd_vehicle_kia_niro )
+#endif
+
+
+typedef struct
+{
+    oscc_obd_signal_t signal;
+    uint8_t start_bit;
+    uint8_t length;
+    bool is_signed;
+    double scale;
+    double offset;
+} obd_signal_s;
+
+typedef struct
+{
+    canid_t can_id;
+    const obd_signal_s *signals;
+    size_t signal_count;
+} obd_frame_s;
+
+typedef struct
+{
+    const obd_frame_s *frames;
+    size_t frame_count;
+} obd_vehicle_s;
+
+
+// Expand a vehicle header's KIA_SOUL_OBD_FRAMES into const tables, e.g.
+// OBD_VEHICLE_DEFINE( obd_vehicle_kia_niro, KIA_SOUL_OBD_FRAMES ).
+//
+// The frames macro lists FRAME( can_id, signals ) for each frame, and each
+// signals macro lists SIGNAL( signal, start_bit, length, is_signed, scale,
+// offset ) for the signals its frame carries, signal being an
+// oscc_obd_signal_t. Start bits count from the least significant bit of the
+// first data byte, and a decoded value is raw * scale + offset.
+#define OBD_SIGNAL_DEFINE( signal, start_bit, length, is_signed, scale, offset ) \
+    { signal, start_bit, length, is_signed, scale, offset },
+
+#define OBD_FRAME_SIGNALS_DEFINE( can_id, signals ) \
+    static const obd_signal_s signals##_TABLE[] = { signals( OBD_SIGNAL_DEFINE ) };
+
+#define OBD_FRAME_DEFINE( can_id, signals ) \
+    { \
+        can_id, \
+        signals##_TABLE, \
+        sizeof(signals##_TABLE) / sizeof(signals##_TABLE[0]) \
+    },
+
+#define OBD_VEHICLE_DEFINE( name, frames ) \
+    frames( OBD_FRAME_SIGNALS_DEFINE ) \
+    static const obd_frame_s name##_frames[] = { frames( OBD_FRAME_DEFINE ) }; \
+    const obd_vehicle_s name = \
+    { \
+        name##_frames, \
+        sizeof(name##_frames) / sizeof(name##_frames[0]) \
+    };
+
+
+extern const obd_vehicle_s obd_vehicle_kia_soul;
+extern const obd_vehicle_s obd_vehicle_kia_soul_ev;
+extern const obd_vehicle_s obd_vehicle_kia_niro;
+
+
+static inline const obd_frame_s * obd_vehicle_frame(
+    const obd_vehicle_s * const vehicle,
+    canid_t can_id )
+{
+    size_t i;
+
+    for ( i = 0; i < vehicle->frame_count; i++ )
+    {
+        if ( vehicle->frames[i].can_id == can_id )
+        {
+            return &vehicle->frames[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Returns the frame carrying the signal, or NULL if the vehicle has none
+static inline const obd_frame_s * obd_vehicle_signal_frame(
+    const obd_vehicle_s * const vehicle,
+    oscc_obd_signal_t signal )
+{
+    size_t i;
+    size_t j;
+
+    for ( i = 0; i < vehicle->frame_count; i++ )
+    {
+        for ( j = 0; j < vehicle->frames[i].signal_count; j++ )
+        {
+            if ( vehicle->frames[i].signals[j].signal == signal )
+            {
+                return &vehicle->frames[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static inline bool obd_frame_carries(
+    const obd_vehicle_s * const vehicle,
+    canid_t can_id,
+    oscc_obd_signal_t signal )
+{
+    const obd_frame_s * const obd_frame = obd_vehicle_signal_frame( vehicle, signal );
+
+    return ( (obd_frame != NULL) && (obd_frame->can_id == can_id) );
+}
+
+static inline double obd_signal_decode(
+    const obd_signal_s * const signal,
+    uint64_t payload )
+{
+    uint64_t mask = ( (signal->length < 64) ? (UINT64_C(1) << signal->length) : 0 ) - 1;
+    uint64_t raw = ( payload >> signal->start_bit ) & mask;
+
+    double value;
+
+    if ( (signal->is_signed == true) && ((raw >> (signal->length - 1)) & 1) )
+    {
+        value = (double) (int64_t) ( raw | ~mask );
+    }
+    else
+    {
+        value = (double) raw;
+    }
+
+    return ( value * signal->scale ) + signal->offset;
+}
+
+// Decodes every signal the frame carries in one pass over its payload and
+// returns a mask of (1 << signal) for the values written.
+static inline unsigned int obd_frame_decode(
+    const obd_frame_s * const obd_frame,
+    const struct can_frame * const frame,
+    double * const values )
+{
+    uint64_t payload;
+    unsigned int decoded = 0;
+    size_t i;
+
+    memcpy( &payload, frame->data, sizeof(payload) );
+    payload = le64toh( payload );
+
+    for ( i = 0; i < obd_frame->signal_count; i++ )
+    {
+        const obd_signal_s * const signal = &obd_frame->signals[i];
+
+        values[signal->signal] = obd_signal_decode( signal, payload );
+        decoded |= ( 1u << signal->signal );
+    }
+
+    return decoded;
+}
+
+// Lets the payload of a frame be loaded as one word without a memcpy, which
+// keeps the loads in obd_frames_decode_wheel_speeds vectorizable
+typedef uint64_t __attribute__(( may_alias )) obd_payload_t;
+
+// Decodes the wheel speeds of many frames carrying the same signals into
+// OSCC_WHEEL_SPEED_COUNT values per frame. Each signal is extracted from every
+// frame in a loop of its own without branches, which the compiler can
+// vectorize for unsigned signals narrower than 32 bits.
+static inline void obd_frames_decode_wheel_speeds(
+    const obd_frame_s * const obd_frame,
+    const struct can_frame * const frames,
+    size_t count,
+    double * const wheel_speeds )
+{
+    size_t i;
+    size_t j;
+
+    for ( j = 0; j < obd_frame->signal_count; j++ )
+    {
+        const obd_signal_s * const signal = &obd_frame->signals[j];
+        const size_t wheel = signal->signal - OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT;
+
+        if ( wheel >= OSCC_WHEEL_SPEED_COUNT )
+        {
+            continue;
+        }
+
+        if ( (signal->is_signed == false) && (signal->length < 32) )
+        {
+            const unsigned int shift = signal->start_bit;
+            const uint64_t mask = ( UINT64_C(1) << signal->length ) - 1;
+            const double scale = signal->scale;
+            const double offset = signal->offset;
+
+            for ( i = 0; i < count; i++ )
+            {
+                const uint64_t payload = le64toh( *(const obd_payload_t *) frames[i].data );
+                const int32_t raw = (int32_t) ( (payload >> shift) & mask );
+
+                wheel_speeds[(i * OSCC_WHEEL_SPEED_COUNT) + wheel] = ( (double) raw * scale ) + offset;
+            }
+        }
+        else
+        {
+            for ( i = 0; i < count; i++ )
+            {
+                wheel_speeds[(i * OSCC_WHEEL_SPEED_COUNT) + wheel] = obd_signal_decode(
+                    signal,
+                    le64toh( *(const obd_payload_t *) frames[i].data ) );
+            }
+        }
+    }
+}
+
+
+#endif /* _OSCC_OBD_DECODER_H */
@@ -7,11 +7,77 @@
  #ifndef _OSCC_INTERNAL_H
  #define _OSCC_INTERNAL_H
 
+#include <limits.h>
+#include <linux/can/raw.h>
 #include <net/if.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <sys/socket.h>
+
+#include "internal/frame_log.h"
+#include "internal/frame_queue.h"
+#include "internal/io_ring.h"
+#include "internal/obd_decoder.h"
+#include "internal/snapshot.h"
+#include "internal/stats.h"
 
 #define UNINITIALIZED_SOCKET (-1)
 
+#define RECEIVE_EPOLL_MAX_EVENTS (3)
+// Stack of each real-time receive thread, smaller than the default so locking
+// memory does not pin megabytes of stack that is never used
+#define RECEIVE_THREAD_STACK_SIZE (512 * 1024)
+
+#define CAN_WRITE_BATCH_SIZE_MAX (8)
+
+#define CAN_FILTER_REPORT_COUNT (4)
+
+// Beyond this many filters the kernel refuses the list, so every frame is
+// accepted instead
+#define CAN_FILTER_COUNT_MAX (CAN_RAW_FILTER_MAX)
+
+// One slot for every standard (11-bit) CAN ID
+#define CAN_DISPATCH_TABLE_SIZE (CAN_SFF_MASK + 1)
+
+#define CAN_DETECTION_CHANNELS_MAX (16)
+
+// Set in a transmit slot while its command has not been sent
+#define TRANSMIT_SLOT_PENDING (UINT64_C(1) << 32)
+
+// TC_PRIO_CONTROL, which the default qdisc queues ahead of everything else
+#define PRIORITY_LANE_SO_PRIORITY (7)
+
+// Enable and disable requests whose frames may be awaiting their echo
+#define PRIORITY_LANE_REQUESTS_MAX (8)
+
+#define NETLINK_BUFFER_SIZE (16384)
+
+// Room for the three timespecs of SO_TIMESTAMPING, which also fits the single
+// one of the SO_TIMESTAMPNS fallback, and the drop count of SO_RXQ_OVFL
+#define RECEIVE_CONTROL_SIZE \
+    (CMSG_SPACE(3 * sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t)))
+
+// Longest a context waits for SIGIO handlers to leave it, and how often it
+// checks
+#define SIGNAL_HANDLER_WAIT_NS (UINT64_C(1000000000))
+#define SIGNAL_HANDLER_POLL_NS (100000)
+
+// Bus load is measured over windows this long
+#define BUS_LOAD_WINDOW_NS (UINT64_C(1000000000))
+
+// Worst-case bits a frame with a payload of dlc bytes and an ID header of
+// header_bits occupies on the bus: the header and payload with up to one stuff
+// bit per four bits, then CRC delimiter, ACK, EOF and interframe space
+#define CAN_FRAME_BITS(header_bits, dlc) \
+    ((header_bits) + (8 * (dlc)) + 13 + (((header_bits) + (8 * (dlc)) - 1) / 4))
+
+// Bits up to the CRC of standard and extended frames that can be stuffed
+#define CAN_STANDARD_HEADER_BITS (34)
+#define CAN_EXTENDED_HEADER_BITS (54)
+
+// Match a standard frame's exact ID, excluding extended frames sharing its bits
+#define CAN_FILTER_EXACT_MASK (CAN_SFF_MASK | CAN_EFF_FLAG)
+
 #define CONSTRAIN(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
 
 typedef struct {
@@ -36,84 +102,739 @@ typedef struct {
     size_t size;
 } device_names_s;
 
-void (*brake_report_callback)(
-    oscc_brake_report_s *report );
+typedef struct {
+    int socket;
+    const obd_vehicle_s *obd_vehicle;
+    oscc_can_desc_s oscc;
+    vehicle_can_desc_s vehicle;
+    unsigned int frames;
+    long long last_frame_ms;
+    bool done;
+} can_probe_s;
+
+typedef struct {
+    canid_t ids[OSCC_OBD_FILTER_SIZE_MAX];
+    unsigned int size;
+    bool enabled;
+} obd_filter_s;
+
+typedef struct {
+    atomic_uint_fast64_t frames;
+    atomic_uint_fast64_t bytes;
+    atomic_uint_fast64_t drops;
+    atomic_uint_fast64_t last_seen_ns;
+} can_id_counters_s;
+
+typedef struct {
+    can_id_counters_s ids[CAN_DISPATCH_TABLE_SIZE];
+    can_id_counters_s extended; // Shared by every extended frame
+    atomic_uint_fast64_t bits;
+    atomic_uint_fast64_t window_start_ns;
+    atomic_uint_fast64_t window_bits;
+    atomic_uint_fast64_t load_ppm; // Load of the latest complete window
+    atomic_uint_fast32_t overflows; // Latest SO_RXQ_OVFL count
+    uint64_t interface_sample_ns; // Start of the interface counters' window
+    uint64_t interface_frames;
+    uint64_t interface_bytes;
+    uint64_t interface_load_ppm;
+} bus_counters_s;
+
+// Lives on the stack of each drain, as the SIGIO handler can run on any
+// thread while another drain of the same context is still dispatching
+typedef struct {
+    struct mmsghdr headers[OSCC_RECEIVE_BATCH_SIZE_MAX];
+    struct iovec iovecs[OSCC_RECEIVE_BATCH_SIZE_MAX];
+    oscc_rx_frame_s frames[OSCC_RECEIVE_BATCH_SIZE_MAX];
+    char control[OSCC_RECEIVE_BATCH_SIZE_MAX][RECEIVE_CONTROL_SIZE];
+} receive_buffers_s;
+
+typedef struct {
+    unsigned int size;
+    atomic_uint_fast64_t syscalls;
+    atomic_uint_fast64_t frames_received;
+} receive_batch_s;
+
+typedef struct {
+    pthread_t receive_thread;
+    pthread_t dispatch_thread;
+    int epoll_fd;
+    int stop_fd;
+    int dispatch_fd;
+    atomic_bool running;
+    bool started;
+    int priority; // SCHED_FIFO priority, zero for the default policy
+    int cpu; // Core the threads are pinned to, -1 for any
+    bool lock_memory;
+    oscc_busy_poll_s busy_poll;
+    oscc_io_backend_t io_backend;
+    bool io_ring_active; // io_backend is io_uring and the kernel supports it
+    io_ring_receiver_s receiver;
+    io_ring_s transmit_ring;
+    pthread_mutex_t transmit_lock; // Held while transmit_ring is in use
+    frame_queue_s queue;
+} receive_engine_s;
+
+typedef enum {
+    TRANSMIT_SLOT_BRAKE,
+    TRANSMIT_SLOT_THROTTLE,
+    TRANSMIT_SLOT_STEERING,
+    TRANSMIT_SLOT_COUNT
+} transmit_slot_t;
+
+typedef struct {
+    pthread_t thread;
+    int timer_fd;
+    int stop_fd;
+    unsigned int rate;
+    atomic_bool running;
+    bool started;
+    // Bits of the latest float command, or'd with TRANSMIT_SLOT_PENDING until
+    // the scheduler has taken it
+    atomic_uint_fast64_t slots[TRANSMIT_SLOT_COUNT];
+} transmit_scheduler_s;
+
+typedef struct {
+    pthread_t thread;
+    int timer_fd;
+    int stop_fd;
+    double period_multiple;
+    bool auto_disable;
+    atomic_bool running;
+    bool started;
+    // CLOCK_MONOTONIC time the latest report of each stream was decoded
+    atomic_uint_fast64_t last_report_ns[OSCC_REPORT_STREAM_COUNT];
+    atomic_bool stale[OSCC_REPORT_STREAM_COUNT];
+} report_watchdog_s;
+
+typedef struct {
+    int event_fd; // Created by the first confirmed call, signalled by reports
+    atomic_bool busy; // A confirmed call is in progress
+    atomic_bool waiting; // Reports are being matched against target
+    atomic_bool target; // Enabled state being waited for
+    // CLOCK_MONOTONIC time the first report showing target was decoded
+    atomic_uint_fast64_t confirmed_ns[OSCC_REPORT_STREAM_COUNT];
+} enable_confirmation_s;
+
+typedef struct {
+    struct timespec requested;
+    unsigned int frames_remaining;
+} priority_request_s;
+
+// Socket for enable and disable frames. Requests are matched to the echoes
+// of their frames in the order they were sent.
+typedef struct {
+    int socket;
+    pthread_mutex_t lock;
+    priority_request_s requests[PRIORITY_LANE_REQUESTS_MAX];
+    unsigned int head;
+    unsigned int count;
+    uint64_t last_ns;
+    uint64_t worst_ns;
+    uint64_t measured;
+} priority_lane_s;
+
+typedef struct {
+    void (*brake_report)(
+        oscc_brake_report_s *report );
+
+    void (*steering_report)(
+        oscc_steering_report_s *report );
+
+    void (*throttle_report)(
+        oscc_throttle_report_s *report );
+
+    void (*fault_report)(
+        oscc_fault_report_s *report );
+
+    void (*obd_frame)(
+        struct can_frame *frame );
 
-void (*steering_report_callback)(
-    oscc_steering_report_s *report );
+    void (*brake_report_timestamped)(
+        oscc_brake_report_s *report,
+        const struct timespec *timestamp );
 
-void (*throttle_report_callback)(
-    oscc_throttle_report_s *report );
+    void (*steering_report_timestamped)(
+        oscc_steering_report_s *report,
+        const struct timespec *timestamp );
 
-void (*fault_report_callback)(
-    oscc_fault_report_s *report );
+    void (*throttle_report_timestamped)(
+        oscc_throttle_report_s *report,
+        const struct timespec *timestamp );
 
-void (*obd_frame_callback)(
-    struct can_frame *frame );
+    void (*fault_report_timestamped)(
+        oscc_fault_report_s *report,
+        const struct timespec *timestamp );
 
-oscc_result_t oscc_can_write(
+    void (*obd_frame_timestamped)(
+        struct can_frame *frame,
+        const struct timespec *timestamp );
+
+    void (*report_stale)(
+        oscc_report_stream_t stream );
+} callbacks_s;
+
+// Decodes a frame for the context's callbacks and snapshots
+typedef void (*frame_decoder_t)(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp );
+
+typedef struct {
+    oscc_can_id_handler_t handler;
+    void *user_data;
+} can_id_subscription_s;
+
+typedef struct {
+    frame_decoder_t report_decoder; // Frames carrying the OSCC magic bytes
+    const obd_frame_s *obd_frame; // Signals the vehicle carries in the frame
+    seqlock_s subscription_lock; // Written under filter_lock
+    can_id_subscription_s subscription; // Changes as a pair while dispatching
+} dispatch_entry_s;
+
+void oscc_decode_brake_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp );
+
+void oscc_decode_steering_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp );
+
+void oscc_decode_throttle_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp );
+
+void oscc_decode_fault_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp );
+
+void oscc_decode_obd_signals(
+    oscc_context_t * const context,
+    const obd_frame_s * const obd_frame,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp );
+
+struct oscc_context_s {
+    int oscc_can_socket;
+    int vehicle_can_socket;
+    char oscc_can_channel[IFNAMSIZ];
+    char vehicle_can_channel[IFNAMSIZ];
+    oscc_receive_mode_t receive_mode;
+    atomic_flag signal_draining;
+    atomic_bool signal_drain_pending;
+    callbacks_s callbacks;
+    obd_filter_s obd_filter;
+    void *user_data;
+    const obd_vehicle_s *obd_vehicle;
+    pthread_mutex_t filter_lock;
+    pthread_mutex_t bus_stats_lock;
+    atomic_bool snapshots_enabled;
+    bool snapshots_writable;
+    snapshot_store_s *snapshots_mapping;
+    char snapshots_name[NAME_MAX];
+    snapshot_store_s snapshots;
+    dispatch_entry_s dispatch_table[CAN_DISPATCH_TABLE_SIZE];
+    receive_batch_s receive_batch;
+    receive_engine_s receive_engine;
+    transmit_scheduler_s transmit_scheduler;
+    report_watchdog_s report_watchdog;
+    enable_confirmation_s enable_confirmation;
+    priority_lane_s priority_lane;
+    bus_counters_s bus_counters[OSCC_CAN_BUS_COUNT];
+    frame_recorder_s recorder;
+#ifdef OSCC_STATS
+    stats_s stats;
+#endif
+};
+
+#define OSCC_CONTEXT_INITIALIZER \
+    { \
+        .oscc_can_socket = UNINITIALIZED_SOCKET, \
+        .vehicle_can_socket = UNINITIALIZED_SOCKET, \
+        .receive_mode = OSCC_RECEIVE_MODE_SIGNAL, \
+        .signal_draining = ATOMIC_FLAG_INIT, \
+        .signal_drain_pending = false, \
+        .obd_filter = { .size = 0, .enabled = false }, \
+        .obd_vehicle = &OBD_VEHICLE_DEFAULT, \
+        .filter_lock = PTHREAD_MUTEX_INITIALIZER, \
+        .bus_stats_lock = PTHREAD_MUTEX_INITIALIZER, \
+        .snapshots_enabled = false, \
+        .snapshots_writable = true, \
+        .snapshots_mapping = NULL, \
+        .dispatch_table = \
+        { \
+            [OSCC_BRAKE_REPORT_CAN_ID] = { .report_decoder = oscc_decode_brake_report }, \
+            [OSCC_STEERING_REPORT_CAN_ID] = { .report_decoder = oscc_decode_steering_report }, \
+            [OSCC_THROTTLE_REPORT_CAN_ID] = { .report_decoder = oscc_decode_throttle_report }, \
+            [OSCC_FAULT_REPORT_CAN_ID] = { .report_decoder = oscc_decode_fault_report } \
+        }, \
+        .receive_batch = { .size = OSCC_RECEIVE_BATCH_SIZE_DEFAULT }, \
+        .receive_engine = \
+        { \
+            .epoll_fd = UNINITIALIZED_SOCKET, \
+            .stop_fd = UNINITIALIZED_SOCKET, \
+            .dispatch_fd = UNINITIALIZED_SOCKET, \
+            .started = false, \
+            .priority = 0, \
+            .cpu = -1, \
+            .lock_memory = false, \
+            .busy_poll = \
+            { \
+                .spin_budget = OSCC_BUSY_POLL_SPIN_BUDGET_DEFAULT, \
+                .backoff = OSCC_BUSY_POLL_BACKOFF_NONE \
+            }, \
+            .io_backend = OSCC_IO_BACKEND_EPOLL, \
+            .io_ring_active = false, \
+            .receiver = { .ring = { .fd = UNINITIALIZED_SOCKET } }, \
+            .transmit_ring = { .fd = UNINITIALIZED_SOCKET }, \
+            .transmit_lock = PTHREAD_MUTEX_INITIALIZER \
+        }, \
+        .transmit_scheduler = \
+        { \
+            .timer_fd = UNINITIALIZED_SOCKET, \
+            .stop_fd = UNINITIALIZED_SOCKET, \
+            .rate = 0, \
+            .started = false \
+        }, \
+        .report_watchdog = \
+        { \
+            .timer_fd = UNINITIALIZED_SOCKET, \
+            .stop_fd = UNINITIALIZED_SOCKET, \
+            .period_multiple = 0, \
+            .auto_disable = false, \
+            .started = false \
+        }, \
+        .enable_confirmation = { .event_fd = UNINITIALIZED_SOCKET }, \
+        STATS_CONTEXT_INITIALIZER \
+        .priority_lane = \
+        { \
+            .socket = UNINITIALIZED_SOCKET, \
+            .lock = PTHREAD_MUTEX_INITIALIZER \
+        }, \
+        .recorder = { .fd = -1, .writers = 0 } \
+    }
+
+// Handles a frame read by oscc_drain_socket on behalf of a context
+typedef void (*frame_handler_t)(
+    oscc_context_t * const context,
+    oscc_rx_frame_s * const rx_frame );
+
+// Adds a context to the set the SIGIO handler drains, returns OSCC_ERROR if
+// OSCC_CONTEXT_COUNT_MAX contexts already exist
+oscc_result_t oscc_context_register( oscc_context_t * const context );
+
+// Removes a context from the set the SIGIO handler drains and waits for any
+// handler still using it to return
+void oscc_context_unregister( oscc_context_t * const context );
+
+// Waits up to SIGNAL_HANDLER_WAIT_NS for SIGIO handlers on other threads to
+// return, returns OSCC_ERROR if one is still running
+oscc_result_t oscc_wait_for_signal_handlers( void );
+
+// Returns true if another context has a socket open on the CAN channel
+bool oscc_channel_claimed(
+    const oscc_context_t * const context,
+    const char * can_channel );
+
+// Makes the opened sockets deliver frames the way the context's receive mode
+// asks for
+oscc_result_t oscc_start_receiving( oscc_context_t * const context );
+
+// Points the dispatch table at the frames of the context's vehicle. Must not
+// run while frames are being dispatched.
+void oscc_map_obd_frames( oscc_context_t * const context );
+
+// Context dispatching the current frame, or the default context outside of a
+// callback. Decides the vehicle that functions without a context decode for.
+const oscc_context_t * oscc_decoding_context( void );
+
+// Returns the store a context's snapshots are kept in, shared or not
+snapshot_store_s * oscc_snapshot_store( oscc_context_t * const context );
+
+// Returns true if received frames should update the context's snapshots
+bool oscc_snapshots_tracked( const oscc_context_t * const context );
+
+// Unmaps a context's shared snapshots, removing them if the context shared
+// them
+void oscc_release_snapshots( oscc_context_t * const context );
+
+// Sends every frame to a CAN socket with a single sendmmsg call
+oscc_result_t oscc_can_send(
+    int socket,
+    struct can_frame * const frames,
+    unsigned int count );
+
+// Sends enable or disable frames ahead of queued commands and records when
+// they were requested
+oscc_result_t oscc_priority_write(
+    oscc_context_t * const context,
+    struct can_frame * const frames,
+    unsigned int count );
+
+// Matches the echoes of priority frames to their requests. Must be called
+// with the lane's lock held.
+void oscc_priority_lane_drain( oscc_context_t * const context );
+
+// Opens the write socket for enable and disable frames on a channel
+int init_priority_socket( const char * can_channel );
+
+// Sends every frame to the OSCC CAN socket with a single sendmmsg call
+oscc_result_t oscc_can_write_frames(
+    oscc_context_t * const context,
+    struct can_frame * const frames,
+    unsigned int count );
+
+void oscc_build_frame(
+    struct can_frame * const frame,
     long id,
-    void *msg,
+    const void *msg,
     unsigned int dlc );
 
-oscc_result_t oscc_enable_brakes(
-    void );
+void oscc_build_brake_command(
+    struct can_frame * const frame,
+    double brake_position );
 
-oscc_result_t oscc_enable_steering(
-    void );
+void oscc_build_throttle_command(
+    struct can_frame * const frame,
+    double throttle_position );
 
-oscc_result_t oscc_enable_throttle(
-    void );
+void oscc_build_steering_command(
+    struct can_frame * const frame,
+    double torque );
 
-oscc_result_t oscc_disable_brakes(
-    void );
 
-oscc_result_t oscc_disable_steering(
-    void );
+void oscc_update_status( );
 
-oscc_result_t oscc_disable_throttle(
-    void );
+// Hands a received frame to the callback registered for its CAN ID
+void oscc_dispatch_frame(
+    oscc_context_t * const context,
+    oscc_rx_frame_s * const rx_frame );
 
-void oscc_update_status( );
+// Hands a frame from the vehicle to the OBD callbacks
+void oscc_dispatch_obd_frame(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp );
 
 oscc_result_t register_can_signal();
 
+// Asks the kernel to timestamp every frame received on a socket, preferring
+// hardware timestamps and falling back to software ones
+oscc_result_t oscc_enable_timestamps( int socket );
+
+// Copies the receive timestamp out of a message's control data, returns false
+// if the kernel did not attach one
+bool oscc_read_timestamp(
+    struct msghdr * const message,
+    struct timespec * const timestamp );
+
+// Asks the kernel to attach to received frames the number of frames it has
+// discarded because the socket's receive queue was full
+oscc_result_t oscc_enable_overflow_counter( int socket );
+
+// Copies the SO_RXQ_OVFL count out of a message's control data, returns false
+// if the kernel did not attach one
+bool oscc_read_overflows(
+    struct msghdr * const message,
+    uint32_t * const overflows );
+
+// Adds a received frame to the counters of its bus and CAN ID
+void oscc_count_frame(
+    oscc_context_t * const context,
+    const oscc_rx_frame_s * const rx_frame );
+
+// Counts a received frame that was never delivered
+void oscc_count_drop(
+    oscc_context_t * const context,
+    const oscc_rx_frame_s * const rx_frame );
+
+// Reads the frames and payload bytes a CAN interface has received and sent.
+// Returns false if the interface or its counters could not be read.
+bool oscc_read_interface_counters(
+    const char * channel,
+    uint64_t * const frames,
+    uint64_t * const bytes );
+
+// Recomputes a bus's load from its interface's counters once a window has
+// passed, leaving it in load_ppm if that is not NULL. Returns false if the
+// bus has no interface or its counters could not be read.
+bool oscc_sample_interface_load(
+    oscc_context_t * const context,
+    oscc_can_bus_t bus,
+    uint64_t * const load_ppm );
+
+// Appends frames to the log being recorded, if any. Safe to call from the
+// SIGIO handler
+void oscc_record_frames(
+    oscc_context_t * const context,
+    const oscc_rx_frame_s * const rx_frames,
+    unsigned int count );
+
+// Checks the header of a frame log and drops a record left incomplete by a
+// crash, returns OSCC_ERROR if fd holds something else
+oscc_result_t oscc_frame_log_prepare( int fd );
+
+// Installs kernel CAN filters on both sockets so that only frames with a
+// registered consumer are received. Must be called whenever a subscription
+// changes.
+oscc_result_t oscc_update_can_filters( oscc_context_t * const context );
+
+// Appends a filter matching exactly one CAN ID, returns false if the list is
+// already full
+bool oscc_add_can_filter(
+    struct can_filter * const filters,
+    unsigned int * const count,
+    canid_t can_id );
+
+// Installs the CAN filters for the report and/or OBD subscriptions, and for
+// every per-ID handler, on a socket
+oscc_result_t oscc_apply_can_filters(
+    oscc_context_t * const context,
+    int socket,
+    bool include_reports,
+    bool include_obd );
+
+// Starts the epoll receive thread and the thread dispatching its frames to
+// the registered callbacks
+oscc_result_t oscc_receive_thread_start( oscc_context_t * const context );
+
+// Stops and joins both receive engine threads if they are running
+oscc_result_t oscc_receive_thread_stop( oscc_context_t * const context );
+
+// Sets up the io_uring receive and transmit rings of a context, returns
+// OSCC_ERROR if the kernel lacks anything they need
+oscc_result_t oscc_io_ring_start( oscc_context_t * const context );
+
+// Tears down the rings once the receive thread using them is gone
+void oscc_io_ring_stop( oscc_context_t * const context );
+
+// Maps the rings of an io_uring set up with flags
+oscc_result_t oscc_io_ring_open( io_ring_s * const ring, unsigned int flags );
+
+void oscc_io_ring_close( io_ring_s * const ring );
+
+// Queues a multishot receive from the socket of bus into the provided buffers
+oscc_result_t oscc_io_ring_arm_receive(
+    oscc_context_t * const context,
+    oscc_can_bus_t bus );
+
+// Writes frames in order as linked sends and waits for all of them, in a
+// single io_uring_enter unless interrupted
+oscc_result_t oscc_io_ring_send(
+    io_ring_s * const ring,
+    int socket,
+    struct can_frame * const frames,
+    unsigned int count );
+
+// Starts the thread of OSCC_RECEIVE_MODE_BUSY_POLL, which polls both sockets
+// and runs the callbacks itself. Stopped by oscc_receive_thread_stop.
+oscc_result_t oscc_busy_poll_thread_start( oscc_context_t * const context );
+
+// Locks memory if a receive engine asks for it and applies its real-time
+// settings to the attributes its threads are created with
+oscc_result_t oscc_receive_thread_attributes(
+    const receive_engine_s * const engine,
+    pthread_attr_t * const attributes );
+
+// Starts the thread sending scheduled commands if a transmit rate is set
+oscc_result_t oscc_transmit_thread_start( oscc_context_t * const context );
+
+// Stops and joins the transmit thread if it is running
+oscc_result_t oscc_transmit_thread_stop( oscc_context_t * const context );
+
+// Sends the commands published since its last tick at the transmit rate
+void * oscc_transmit_thread( void * arg );
+
+// Sends the pending scheduled commands in one batch
+void oscc_transmit_pending( oscc_context_t * const context );
+
+// Builds the command frame of a transmit slot
+void oscc_build_command(
+    struct can_frame * const frame,
+    transmit_slot_t slot,
+    double command );
+
+// Replaces a module's latest command, to be sent on the next tick
+void oscc_schedule_command(
+    oscc_context_t * const context,
+    transmit_slot_t slot,
+    double command );
+
+// Starts the thread that marks report streams stale, if a watchdog is set
+oscc_result_t oscc_report_watchdog_start( oscc_context_t * const context );
+
+oscc_result_t oscc_report_watchdog_stop( oscc_context_t * const context );
+
+// Waits on the watchdog timer, which is always armed for the next deadline
+void * oscc_report_watchdog_thread( void * arg );
+
+// Checks every stream against its deadline, returns when the next one is due
+uint64_t oscc_report_watchdog_check(
+    oscc_context_t * const context,
+    uint64_t now_ns );
+
+// Notes that a report arrived, called for every OSCC report decoded
+void oscc_report_watchdog_feed(
+    oscc_context_t * const context,
+    canid_t can_id );
+
+// Sends the enable or disable frames and waits for the modules' reports to
+// show the new state
+oscc_result_t oscc_confirm_state_change(
+    oscc_context_t * const context,
+    bool enable,
+    unsigned int timeout_ms,
+    oscc_confirmation_s * const confirmation );
+
+// Wakes a confirmed call waiting for the state a module just reported
+void oscc_confirm_report(
+    oscc_context_t * const context,
+    oscc_report_stream_t stream,
+    bool enabled );
+
+// Publishes commands straight away or through the transmit scheduler
+oscc_result_t oscc_publish_frames(
+    oscc_context_t * const context,
+    const transmit_slot_t * const slots,
+    const double * const commands,
+    unsigned int count );
+
+#ifdef OSCC_STATS
+// Records the interval since the module's previous report and, if a command
+// was published to it since its last report, the command-to-report latency
+void oscc_stats_report(
+    oscc_context_t * const context,
+    canid_t can_id,
+    const struct timespec * const timestamp );
+
+// Marks when commands were published for the next report to measure from
+void oscc_stats_commands(
+    oscc_context_t * const context,
+    const transmit_slot_t * const slots,
+    unsigned int count );
+#endif
+
+// Waits on both CAN sockets and queues every frame read from them
+void * oscc_receive_thread( void * arg );
+
+// Drains the frame queue into the registered callbacks
+void * oscc_dispatch_thread( void * arg );
+
+// Takes frames from the completions of the io_uring receive ring and hands
+// them to the dispatch thread, in place of oscc_receive_thread
+void * oscc_io_ring_receive_thread( void * arg );
+
+// Spins on both sockets, backing off as configured while they are idle
+void * oscc_busy_poll_thread( void * arg );
+
+// Pushes a received frame into the receive thread's frame queue
+void oscc_queue_frame(
+    oscc_context_t * const context,
+    oscc_rx_frame_s * const rx_frame );
+
+// Reads pending frames from a socket with batched recvmmsg calls, up to
+// max_frames, and hands each one to frame_handler. Returns the number of
+// frames read.
+unsigned int oscc_drain_socket(
+    oscc_context_t * const context,
+    int socket,
+    oscc_can_bus_t bus,
+    frame_handler_t frame_handler,
+    unsigned int max_frames );
+
+// Fills in the bus and receive timestamp of a frame read with message, or
+// now if the kernel gave no timestamp, and counts it
+void oscc_accept_frame(
+    oscc_context_t * const context,
+    struct msghdr * const message,
+    oscc_can_bus_t bus,
+    const struct timespec * const now,
+    oscc_rx_frame_s * const rx_frame );
+
+// Records accepted frames if a recording is running and hands each one to
+// frame_handler
+void oscc_deliver_frames(
+    oscc_context_t * const context,
+    oscc_rx_frame_s * const rx_frames,
+    unsigned int count,
+    frame_handler_t frame_handler );
+
 // Enables asynchronous callback to each socket and should only be called after
 // all connections are made to prevent interrupts while making new connections.
 oscc_result_t oscc_async_enable(
+    oscc_context_t * const context,
     int socket );
 
-// Runs a calback function through all available socketcan signals
+// Probes all socketcan channels not claimed by another context at once and
+// runs a callback function with what was detected on each of them, in order
 oscc_result_t oscc_search_can(
-    can_contains_s(*search_callback)( const char * ),
+    oscc_context_t * const context,
+    can_contains_s(*search_callback)( oscc_context_t *, const char *, can_contains_s ),
     bool search_oscc );
 
-// Auto detects OSCC CAN and Vehicle CAN depending on OSCC CAN returned IDs
-can_contains_s auto_init_all_can( const char * can_channel );
+// Initializes OSCC CAN or Vehicle CAN depending on OSCC CAN returned IDs
+can_contains_s auto_init_all_can(
+    oscc_context_t * const context,
+    const char * can_channel,
+    can_contains_s contents );
 
-// Auto detects Vehicle CAN based on vehicle header CAN IDs
-can_contains_s auto_init_vehicle_can( const char * can_channel );
+// Initializes Vehicle CAN if it has the vehicle header CAN IDs
+can_contains_s auto_init_vehicle_can(
+    oscc_context_t * const context,
+    const char * can_channel,
+    can_contains_s contents );
 
 // Initializes the OSCC CAN
-oscc_result_t init_oscc_can( const char * can_channel );
+oscc_result_t init_oscc_can(
+    oscc_context_t * const context,
+    const char * can_channel );
 
 // Initializes the vehicle can with vehicle header CAN IDs
-oscc_result_t init_vehicle_can( const char * can_channel );
+oscc_result_t init_vehicle_can(
+    oscc_context_t * const context,
+    const char * can_channel );
 
 // Returns socket id after initiating a socketcan connection
 int init_can_socket( const char * can_channel,
                      struct timeval * tv );
 
 // Determines if the CAN channel contains OSCC data and/or Vehicle CAN IDs
-can_contains_s can_detection( const char * can_channel );
+can_contains_s can_detection(
+    const char * can_channel,
+    const obd_vehicle_s * const obd_vehicle );
+
+// Determines what every CAN channel contains by probing them all at once.
+// Each channel stops as soon as it is complete, quiet for
+// CAN_MESSAGE_TIMEOUT or has delivered MAX_CAN_IDS frames, and the whole
+// search is bounded by CAN_DETECTION_TIMEOUT.
+oscc_result_t can_detection_all(
+    const char * const * can_channels,
+    size_t count,
+    can_contains_s * const detections,
+    const obd_vehicle_s * const obd_vehicle,
+    bool search_oscc );
+
+// Opens a nonblocking socket that only receives the frames used for detection
+int can_probe_open(
+    const char * can_channel,
+    const obd_vehicle_s * const obd_vehicle );
+
+// Reads every frame waiting on a probe's socket and records its signatures
+void can_probe_read( can_probe_s * const probe, long long now_ms );
 
-// Constructs a list of all can and vcan devices
+// Summarizes what a probe has detected so far
+can_contains_s can_probe_contents( const can_probe_s * const probe );
+
+// Returns CLOCK_MONOTONIC in milliseconds
+long long monotonic_time_ms( void );
+
+// Constructs a list of every CAN device that is up, enumerated over rtnetlink
 oscc_result_t construct_interfaces_list(
     device_names_s * const list_ptr );
 
-// Gets the device name from a line of /proc/net/dev data
-oscc_result_t get_device_name( char * string, char * const name );
-
 oscc_result_t clear_device_names( device_names_s * const names_ptr );
 
 #endif /* _OSCC_INTERNAL_H */
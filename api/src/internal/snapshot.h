@@ -0,0 +1,133 @@
+/**
+ * @file internal/snapshot.h
+ * @brief Seqlock protected store of the latest module reports and OBD
+ *        values, laid out so it can live in shared memory.
+ */
+
+
+#ifndef _OSCC_SNAPSHOT_H
+#define _OSCC_SNAPSHOT_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "oscc.h"
+
+
+/*
+ * @brief Identifies a mapped snapshot store, "OSCS".
+ *
+ */
+#define SNAPSHOT_STORE_MAGIC ( 0x5343534F )
+
+/*
+ * @brief Changes whenever the layout of \ref snapshot_store_s does, so a
+ * process never reads a store written by an incompatible library.
+ *
+ */
+#define SNAPSHOT_STORE_VERSION ( 1 )
+
+/*
+ * @brief Assumed size of a cache line, used to keep each snapshot from sharing
+ * one with its neighbours.
+ *
+ */
+#define SNAPSHOT_CACHE_LINE ( 64 )
+
+
+// The counter is odd while a write is in progress
+typedef struct
+{
+    atomic_uint sequence;
+} seqlock_s;
+
+typedef struct
+{
+    _Alignas( SNAPSHOT_CACHE_LINE ) seqlock_s lock;
+    oscc_brake_report_snapshot_s snapshot;
+} brake_snapshot_slot_s;
+
+typedef struct
+{
+    _Alignas( SNAPSHOT_CACHE_LINE ) seqlock_s lock;
+    oscc_steering_report_snapshot_s snapshot;
+} steering_snapshot_slot_s;
+
+typedef struct
+{
+    _Alignas( SNAPSHOT_CACHE_LINE ) seqlock_s lock;
+    oscc_throttle_report_snapshot_s snapshot;
+} throttle_snapshot_slot_s;
+
+typedef struct
+{
+    _Alignas( SNAPSHOT_CACHE_LINE ) seqlock_s lock;
+    oscc_fault_report_snapshot_s snapshot;
+} fault_snapshot_slot_s;
+
+typedef struct
+{
+    _Alignas( SNAPSHOT_CACHE_LINE ) seqlock_s lock;
+    oscc_obd_snapshot_s snapshot;
+} obd_snapshot_slot_s;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    brake_snapshot_slot_s brake;
+    steering_snapshot_slot_s steering;
+    throttle_snapshot_slot_s throttle;
+    fault_snapshot_slot_s fault;
+    obd_snapshot_slot_s obd;
+} snapshot_store_s;
+
+
+// Must only be called from one thread at a time per lock. Readers never block
+// the writer, they retry instead.
+static inline void seqlock_write(
+    seqlock_s * const lock,
+    void * const destination,
+    const void * const source,
+    size_t size )
+{
+    unsigned int sequence = atomic_load_explicit( &lock->sequence, memory_order_relaxed );
+
+    atomic_store_explicit( &lock->sequence, sequence + 1, memory_order_relaxed );
+    atomic_thread_fence( memory_order_release );
+
+    memcpy( destination, source, size );
+
+    atomic_store_explicit( &lock->sequence, sequence + 2, memory_order_release );
+}
+
+// Copies a consistent version of the data, retrying while a write overlaps
+static inline void seqlock_read(
+    const seqlock_s * const lock,
+    void * const destination,
+    const void * const source,
+    size_t size )
+{
+    unsigned int before;
+    unsigned int after;
+
+    do
+    {
+        before = atomic_load_explicit(
+            (atomic_uint *) &lock->sequence,
+            memory_order_acquire );
+
+        memcpy( destination, source, size );
+
+        atomic_thread_fence( memory_order_acquire );
+
+        after = atomic_load_explicit(
+            (atomic_uint *) &lock->sequence,
+            memory_order_relaxed );
+    } while ( ((before & 1) != 0) || (before != after) );
+}
+
+
+#endif /* _OSCC_SNAPSHOT_H */
@@ -0,0 +1,219 @@
+/**
+ * @file internal/stats.h
+ * @brief Latency histograms collected when the library is built with
+ *        OSCC_STATS. Without it nothing here is compiled into a context.
+ */
+
+
+#ifndef _OSCC_STATS_H
+#define _OSCC_STATS_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "oscc.h"
+
+
+/*
+ * @brief Most bucket bounds a histogram can have, the last bucket counts
+ * every sample above the highest bound.
+ *
+ */
+#define STATS_BOUNDS_MAX ( OSCC_STATS_BUCKET_COUNT - 1 )
+
+/*
+ * @brief Default upper bound of bucket i, doubling from one microsecond.
+ *
+ */
+#define STATS_DEFAULT_BOUND( i ) ( UINT64_C(1000) << (i) )
+
+
+#ifdef OSCC_STATS
+
+typedef struct
+{
+    atomic_uint_fast64_t counts[OSCC_STATS_BUCKET_COUNT];
+    atomic_uint_fast64_t samples;
+    atomic_uint_fast64_t total_ns;
+    atomic_uint_fast64_t min_ns; // Zero until the first sample
+    atomic_uint_fast64_t max_ns;
+} stats_histogram_s;
+
+typedef struct
+{
+    uint64_t bounds_ns[STATS_BOUNDS_MAX];
+    unsigned int bound_count;
+    stats_histogram_s histograms[OSCC_STATS_HISTOGRAM_COUNT];
+    // Time of the event each interval histogram measures from, zero if none
+    atomic_uint_fast64_t marks_ns[OSCC_STATS_HISTOGRAM_COUNT];
+} stats_s;
+
+#define STATS_CONTEXT_INITIALIZER \
+        .stats = \
+        { \
+            .bounds_ns = \
+            { \
+                STATS_DEFAULT_BOUND( 0 ), STATS_DEFAULT_BOUND( 1 ), STATS_DEFAULT_BOUND( 2 ), \
+                STATS_DEFAULT_BOUND( 3 ), STATS_DEFAULT_BOUND( 4 ), STATS_DEFAULT_BOUND( 5 ), \
+                STATS_DEFAULT_BOUND( 6 ), STATS_DEFAULT_BOUND( 7 ), STATS_DEFAULT_BOUND( 8 ), \
+                STATS_DEFAULT_BOUND( 9 ), STATS_DEFAULT_BOUND( 10 ), STATS_DEFAULT_BOUND( 11 ), \
+                STATS_DEFAULT_BOUND( 12 ), STATS_DEFAULT_BOUND( 13 ), STATS_DEFAULT_BOUND( 14 ), \
+                STATS_DEFAULT_BOUND( 15 ), STATS_DEFAULT_BOUND( 16 ), STATS_DEFAULT_BOUND( 17 ), \
+                STATS_DEFAULT_BOUND( 18 ), STATS_DEFAULT_BOUND( 19 ), STATS_DEFAULT_BOUND( 20 ), \
+                STATS_DEFAULT_BOUND( 21 ), STATS_DEFAULT_BOUND( 22 ), STATS_DEFAULT_BOUND( 23 ), \
+                STATS_DEFAULT_BOUND( 24 ), STATS_DEFAULT_BOUND( 25 ), STATS_DEFAULT_BOUND( 26 ), \
+                STATS_DEFAULT_BOUND( 27 ), STATS_DEFAULT_BOUND( 28 ), STATS_DEFAULT_BOUND( 29 ), \
+                STATS_DEFAULT_BOUND( 30 ) \
+            }, \
+            .bound_count = STATS_BOUNDS_MAX \
+        },
+
+// Time a section of code into a histogram, compiled out without OSCC_STATS
+#define STATS_START( start ) const uint64_t start = stats_now_ns( )
+
+#define STATS_RECORD_SINCE( stats, histogram, start ) \
+    stats_record( (stats), (histogram), stats_now_ns( ) - (start) )
+
+
+static inline uint64_t stats_now_ns( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec;
+}
+
+static inline uint64_t stats_timespec_ns( const struct timespec * const time )
+{
+    return ( (uint64_t) time->tv_sec * UINT64_C(1000000000) ) + (uint64_t) time->tv_nsec;
+}
+
+// Bucket i holds samples above bound i - 1 up to and including bound i
+static inline unsigned int stats_bucket( const stats_s * const stats, uint64_t sample_ns )
+{
+    unsigned int low = 0;
+    unsigned int high = stats->bound_count;
+
+    while ( low < high )
+    {
+        unsigned int middle = ( low + high ) / 2;
+
+        if ( sample_ns <= stats->bounds_ns[middle] )
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    return low;
+}
+
+// Safe to call from several threads at once
+static inline void stats_record(
+    stats_s * const stats,
+    oscc_stats_histogram_t histogram,
+    uint64_t sample_ns )
+{
+    stats_histogram_s * const entry = &stats->histograms[histogram];
+
+    atomic_fetch_add_explicit( &entry->counts[stats_bucket( stats, sample_ns )], 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &entry->samples, 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &entry->total_ns, sample_ns, memory_order_relaxed );
+
+    uint_fast64_t current = atomic_load_explicit( &entry->min_ns, memory_order_relaxed );
+
+    while ( ((current == 0) || (sample_ns < current))
+        && !atomic_compare_exchange_weak_explicit(
+            &entry->min_ns, &current, sample_ns,
+            memory_order_relaxed, memory_order_relaxed ) )
+    {
+    }
+
+    current = atomic_load_explicit( &entry->max_ns, memory_order_relaxed );
+
+    while ( (sample_ns > current)
+        && !atomic_compare_exchange_weak_explicit(
+            &entry->max_ns, &current, sample_ns,
+            memory_order_relaxed, memory_order_relaxed ) )
+    {
+    }
+}
+
+// Records the time since the previous event of the same histogram
+static inline void stats_record_interval(
+    stats_s * const stats,
+    oscc_stats_histogram_t histogram,
+    uint64_t now_ns )
+{
+    uint64_t previous_ns = atomic_exchange_explicit(
+        &stats->marks_ns[histogram],
+        now_ns,
+        memory_order_relaxed );
+
+    if ( (previous_ns != 0) && (now_ns > previous_ns) )
+    {
+        stats_record( stats, histogram, now_ns - previous_ns );
+    }
+}
+
+// Records how long ago a frame was received, on the realtime clock its
+// receive timestamp is taken from
+static inline void stats_record_receive(
+    stats_s * const stats,
+    const struct timespec * const timestamp )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_REALTIME, &now );
+
+    const uint64_t now_ns = stats_timespec_ns( &now );
+    const uint64_t received_ns = stats_timespec_ns( timestamp );
+
+    if ( now_ns >= received_ns )
+    {
+        stats_record( stats, OSCC_STATS_RECEIVE_TO_CALLBACK, now_ns - received_ns );
+    }
+}
+
+// Starts an interval that the next stats_record_since_mark call ends
+static inline void stats_mark(
+    stats_s * const stats,
+    oscc_stats_histogram_t histogram,
+    uint64_t now_ns )
+{
+    atomic_store_explicit( &stats->marks_ns[histogram], now_ns, memory_order_relaxed );
+}
+
+static inline void stats_record_since_mark(
+    stats_s * const stats,
+    oscc_stats_histogram_t histogram,
+    uint64_t now_ns )
+{
+    uint64_t mark_ns = atomic_exchange_explicit(
+        &stats->marks_ns[histogram],
+        0,
+        memory_order_relaxed );
+
+    if ( (mark_ns != 0) && (now_ns >= mark_ns) )
+    {
+        stats_record( stats, histogram, now_ns - mark_ns );
+    }
+}
+
+#else
+
+#define STATS_CONTEXT_INITIALIZER
+
+#define STATS_START( start )
+
+#define STATS_RECORD_SINCE( stats, histogram, start )
+
+#endif /* OSCC_STATS */
+
+
+#endif /* _OSCC_STATS_H */
@@ -1,61 +1,239 @@
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
+#include <linux/net_tstamp.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if_arp.h>
 #include <net/if.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/syscall.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <poll.h>
+#include <sched.h>
 
 #include "oscc.h"
 #include "internal/oscc.h"
 
 
-static int global_oscc_can_socket = UNINITIALIZED_SOCKET;
-static int global_vehicle_can_socket = UNINITIALIZED_SOCKET;
+static oscc_context_t global_default_context = OSCC_CONTEXT_INITIALIZER;
 
+// Copied into created contexts rather than building the large initializer on
+// the stack
+static const oscc_context_t global_context_template = OSCC_CONTEXT_INITIALIZER;
 
-oscc_result_t oscc_init()
+// Contexts the SIGIO handler drains. Slots are claimed under the lock but read
+// by the handler without it.
+static _Atomic(oscc_context_t *) global_contexts[OSCC_CONTEXT_COUNT_MAX] =
+{
+    &global_default_context
+};
+
+static pthread_mutex_t global_contexts_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static atomic_uint global_signal_handlers_active = 0;
+
+// SIGIO handlers running on this thread, which a callback closing its context
+// must not wait for
+static __thread uint global_signal_handler_depth
+    __attribute__(( tls_model( "initial-exec" ) )) = 0;
+
+// Initial-exec so that the SIGIO handler never has to allocate the variable
+static __thread oscc_context_t * global_current_context
+    __attribute__(( tls_model( "initial-exec" ) )) = NULL;
+
+static const obd_vehicle_s * const global_obd_vehicles[OSCC_VEHICLE_COUNT] =
+{
+    [OSCC_VEHICLE_KIA_SOUL] = &obd_vehicle_kia_soul,
+    [OSCC_VEHICLE_KIA_SOUL_EV] = &obd_vehicle_kia_soul_ev,
+    [OSCC_VEHICLE_KIA_NIRO] = &obd_vehicle_kia_niro
+};
+
+// Time between reports of each stream as published by its module
+static const uint64_t global_report_periods_ns[OSCC_REPORT_STREAM_COUNT] =
+{
+    [OSCC_REPORT_STREAM_BRAKE] = 1000000000 / OSCC_BRAKE_REPORT_PUBLISH_FREQ_IN_HZ,
+    [OSCC_REPORT_STREAM_THROTTLE] = 1000000000 / OSCC_REPORT_THROTTLE_PUBLISH_FREQ_IN_HZ,
+    [OSCC_REPORT_STREAM_STEERING] = 1000000000 / OSCC_REPORT_STEERING_PUBLISH_FREQ_IN_HZ
+};
+
+// Where each decoded OBD signal and its receive time are kept in a snapshot
+static const struct
+{
+    size_t value;
+    size_t timestamp;
+} global_obd_snapshot_fields[OSCC_OBD_SIGNAL_COUNT] =
+{
+    [OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT] =
+        { offsetof( oscc_obd_snapshot_s, wheel_speed_left_front ),
+          offsetof( oscc_obd_snapshot_s, wheel_speed_timestamp ) },
+    [OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_FRONT] =
+        { offsetof( oscc_obd_snapshot_s, wheel_speed_right_front ),
+          offsetof( oscc_obd_snapshot_s, wheel_speed_timestamp ) },
+    [OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_REAR] =
+        { offsetof( oscc_obd_snapshot_s, wheel_speed_left_rear ),
+          offsetof( oscc_obd_snapshot_s, wheel_speed_timestamp ) },
+    [OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_REAR] =
+        { offsetof( oscc_obd_snapshot_s, wheel_speed_right_rear ),
+          offsetof( oscc_obd_snapshot_s, wheel_speed_timestamp ) },
+    [OSCC_OBD_SIGNAL_STEERING_WHEEL_ANGLE] =
+        { offsetof( oscc_obd_snapshot_s, steering_wheel_angle ),
+          offsetof( oscc_obd_snapshot_s, steering_wheel_angle_timestamp ) },
+    [OSCC_OBD_SIGNAL_BRAKE_PRESSURE] =
+        { offsetof( oscc_obd_snapshot_s, brake_pressure ),
+          offsetof( oscc_obd_snapshot_s, brake_pressure_timestamp ) }
+};
+
+
+oscc_context_t * oscc_default_context( void )
+{
+    return &global_default_context;
+}
+
+oscc_context_t * oscc_context_current( void )
+{
+    return global_current_context;
+}
+
+oscc_result_t oscc_context_create( oscc_context_t ** context )
 {
     oscc_result_t result = OSCC_ERROR;
 
-    result = oscc_search_can( &auto_init_all_can, true );
 
-    if( result == OSCC_OK )
+    if ( context != NULL )
     {
-        result = register_can_signal();
+        void * memory = NULL;
+
+        // The receive queue keeps its indices on separate cache lines
+        if ( posix_memalign( &memory, FRAME_QUEUE_CACHE_LINE, sizeof(oscc_context_t) ) == 0 )
+        {
+            oscc_context_t * created = memory;
+
+            memcpy( created, &global_context_template, sizeof(*created) );
+
+            result = oscc_context_register( created );
+
+            if ( result == OSCC_OK )
+            {
+                *context = created;
+            }
+            else
+            {
+                printf( "Error: Too many OSCC contexts\n" );
+
+                free( created );
+            }
+        }
     }
 
-    if ( result == OSCC_OK && global_oscc_can_socket > 0 )
+
+    return result;
+}
+
+oscc_result_t oscc_context_destroy( oscc_context_t * context )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (context != &global_default_context) )
     {
-        result = oscc_async_enable( global_oscc_can_socket );
+        result = OSCC_OK;
+
+        if ( (context->oscc_can_socket >= 0) || (context->vehicle_can_socket >= 0) )
+        {
+            result = oscc_context_close( context );
+        }
+
+        oscc_context_unregister( context );
+
+        oscc_release_snapshots( context );
+
+        free( context );
     }
-    else
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_user_data( oscc_context_t * context, void * user_data )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( context != NULL )
     {
-        printf( "Error: Could not find OSCC CAN signal\n" );
-        result = OSCC_ERROR;
+        context->user_data = user_data;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+void * oscc_context_get_user_data( const oscc_context_t * context )
+{
+    void * user_data = NULL;
+
+
+    if ( context != NULL )
+    {
+        user_data = context->user_data;
     }
 
-    if ( result == OSCC_OK && global_vehicle_can_socket > 0 )
+
+    return user_data;
+}
+
+oscc_result_t oscc_context_init( oscc_context_t * context )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( context != NULL )
     {
-        oscc_async_enable( global_vehicle_can_socket );
+        result = oscc_search_can( context, &auto_init_all_can, true );
+
+        if ( result == OSCC_OK && context->oscc_can_socket < 0 )
+        {
+            printf( "Error: Could not find OSCC CAN signal\n" );
+            result = OSCC_ERROR;
+        }
+
+        if ( result == OSCC_OK )
+        {
+            result = oscc_start_receiving( context );
+        }
     }
 
+
     return result;
 }
 
-oscc_result_t oscc_open( unsigned int channel )
+oscc_result_t oscc_context_open( oscc_context_t * context, unsigned int channel )
 {
     oscc_result_t result = OSCC_ERROR;
 
+    if ( context == NULL )
+    {
+        return result;
+    }
+
     can_contains_s channel_contents =
         {
             .is_oscc = false,
@@ -66,567 +244,5613 @@ oscc_result_t oscc_open( unsigned int channel )
 
     snprintf( can_string_buffer, 16, "can%u", channel );
 
-    channel_contents = can_detection( can_string_buffer );
+    channel_contents = can_detection( can_string_buffer, context->obd_vehicle );
 
     if( !channel_contents.has_vehicle )
     {
         int vehicle_ret = OSCC_ERROR;
 
-        vehicle_ret = oscc_search_can( &auto_init_vehicle_can, false );
+        vehicle_ret = oscc_search_can( context, &auto_init_vehicle_can, false );
 
-        if( (global_vehicle_can_socket < 0) || (vehicle_ret != OSCC_OK) )
+        if( (context->vehicle_can_socket < 0) || (vehicle_ret != OSCC_OK) )
         {
             printf( "Warning: Vehicle CAN was not found.\n" );
         }
     }
 
-    result = init_oscc_can( can_string_buffer );
-
-    if( result == OSCC_OK)
-    {
-        result = register_can_signal();
-    }
+    result = init_oscc_can( context, can_string_buffer );
 
-    if ( result == OSCC_OK && global_oscc_can_socket >= 0 )
+    if ( result == OSCC_OK )
     {
-        result = oscc_async_enable( global_oscc_can_socket );
+        result = oscc_start_receiving( context );
     }
     else
     {
         printf( "Error: Could not find OSCC CAN signal.\n" );
     }
 
-    if ( result == OSCC_OK && global_vehicle_can_socket >= 0 )
-    {
-        oscc_async_enable( global_vehicle_can_socket );
-    }
-
     return result;
 }
 
-
-oscc_result_t oscc_close( unsigned int channel )
+oscc_result_t oscc_context_open_channels(
+    oscc_context_t * context,
+    const char * oscc_can_channel,
+    const char * vehicle_can_channel )
 {
-    bool closed_channel = false;
-    bool close_errored = false;
+    oscc_result_t result = OSCC_ERROR;
 
-    if( global_oscc_can_socket >= 0 )
+
+    if ( (context != NULL) && (oscc_can_channel != NULL) )
     {
-        int result = close( global_oscc_can_socket );
+        result = init_oscc_can( context, oscc_can_channel );
 
-        if ( result == 0 )
+        if ( result == OSCC_OK && vehicle_can_channel != NULL )
         {
-            closed_channel = true;
+            result = init_vehicle_can( context, vehicle_can_channel );
         }
-        else
+
+        if ( result == OSCC_OK )
         {
-            close_errored = true;
+            result = oscc_start_receiving( context );
         }
     }
 
-    if( global_vehicle_can_socket >= 0 )
+
+    return result;
+}
+
+oscc_result_t oscc_context_close( oscc_context_t * context )
+{
+    bool closed_channel = false;
+    bool close_errored = false;
+
+    if ( context == NULL )
     {
-        int result = close( global_vehicle_can_socket );
+        return OSCC_ERROR;
+    }
 
-        if ( result == 0 )
-        {
-            closed_channel = true;
-        }
-        else
-        {
-            close_errored = true;
-        }
+    // The receive and transmit threads must be gone before their sockets are
+    // closed
+    if ( oscc_receive_thread_stop( context ) != OSCC_OK )
+    {
+        close_errored = true;
     }
 
-    if ( closed_channel == true && close_errored == false )
+    if ( oscc_transmit_thread_stop( context ) != OSCC_OK )
     {
-        return OSCC_OK;
+        close_errored = true;
     }
-    else
+
+    // An automatic disable writes to the sockets too
+    if ( oscc_report_watchdog_stop( context ) != OSCC_OK )
     {
-        return OSCC_ERROR;
+        close_errored = true;
     }
-}
 
-oscc_result_t oscc_enable( void )
-{
-    oscc_result_t result = OSCC_ERROR;
+    int * sockets[] = { &context->oscc_can_socket, &context->vehicle_can_socket };
+
+    int closing[] = { UNINITIALIZED_SOCKET, UNINITIALIZED_SOCKET };
 
+    uint i;
 
-    result = oscc_enable_brakes( );
+    // Hide the sockets from the SIGIO handler, then let handlers that already
+    // read them finish before the descriptors can be reused
+    for ( i = 0; i < (sizeof(sockets) / sizeof(sockets[0])); i++ )
+    {
+        closing[i] = *sockets[i];
 
-    if ( result == OSCC_OK )
+        *sockets[i] = UNINITIALIZED_SOCKET;
+    }
+
+    if ( oscc_wait_for_signal_handlers( ) != OSCC_OK )
     {
-        result = oscc_enable_throttle( );
+        close_errored = true;
+    }
 
-        if (result == OSCC_OK )
+    for ( i = 0; i < (sizeof(closing) / sizeof(closing[0])); i++ )
+    {
+        if( closing[i] >= 0 )
         {
-            result = oscc_enable_steering( );
+            if ( close( closing[i] ) == 0 )
+            {
+                closed_channel = true;
+            }
+            else
+            {
+                close_errored = true;
+            }
         }
     }
 
+    if ( context->priority_lane.socket >= 0 )
+    {
+        close( context->priority_lane.socket );
 
-    return result;
-}
+        context->priority_lane.socket = UNINITIALIZED_SOCKET;
+    }
 
-oscc_result_t oscc_disable( void )
-{
-    oscc_result_t result = OSCC_ERROR;
+    // Handlers confirming a state change write to the event, and none is left
+    if ( context->enable_confirmation.event_fd >= 0 )
+    {
+        close( context->enable_confirmation.event_fd );
 
+        context->enable_confirmation.event_fd = UNINITIALIZED_SOCKET;
+    }
 
-    result = oscc_disable_brakes( );
+    (void) oscc_context_stop_recording( context );
 
-    if ( result == OSCC_OK )
-    {
-        result = oscc_disable_throttle( );
+    pthread_mutex_lock( &context->bus_stats_lock );
 
-        if ( result == OSCC_OK )
-        {
-            result = oscc_disable_steering( );
-        }
+    context->oscc_can_channel[0] = '\0';
+    context->vehicle_can_channel[0] = '\0';
+
+    // Channels opened later start a load window of their own
+    for ( i = 0; i < OSCC_CAN_BUS_COUNT; i++ )
+    {
+        context->bus_counters[i].interface_sample_ns = 0;
+        context->bus_counters[i].interface_load_ppm = 0;
     }
 
+    pthread_mutex_unlock( &context->bus_stats_lock );
 
-    return result;
+    if ( closed_channel == true && close_errored == false )
+    {
+        return OSCC_OK;
+    }
+    else
+    {
+        return OSCC_ERROR;
+    }
 }
 
-oscc_result_t oscc_publish_brake_position( double brake_position )
+oscc_result_t oscc_context_enable( oscc_context_t * context )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    oscc_brake_command_s brake_cmd =
+    oscc_brake_enable_s brake_enable =
     {
         .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
         .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
     };
 
-    brake_cmd.pedal_command = (float) brake_position;
-
-    result = oscc_can_write(
-        OSCC_BRAKE_COMMAND_CAN_ID,
-        (void *) &brake_cmd,
-        sizeof(brake_cmd) );
-
-
-    return result;
-}
-
-oscc_result_t oscc_publish_throttle_position( double throttle_position )
-{
-    oscc_result_t result = OSCC_ERROR;
-
+    oscc_throttle_enable_s throttle_enable =
+    {
+        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
+        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
+    };
 
-    oscc_throttle_command_s throttle_cmd =
+    oscc_steering_enable_s steering_enable =
     {
         .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
         .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
     };
 
-    throttle_cmd.torque_request = (float) throttle_position;
+    struct can_frame frames[3];
+
+    oscc_build_frame( &frames[0], OSCC_BRAKE_ENABLE_CAN_ID, &brake_enable, sizeof(brake_enable) );
+    oscc_build_frame( &frames[1], OSCC_THROTTLE_ENABLE_CAN_ID, &throttle_enable, sizeof(throttle_enable) );
+    oscc_build_frame( &frames[2], OSCC_STEERING_ENABLE_CAN_ID, &steering_enable, sizeof(steering_enable) );
 
-    result = oscc_can_write(
-        OSCC_THROTTLE_COMMAND_CAN_ID,
-        (void *) &throttle_cmd,
-        sizeof(throttle_cmd) );
+    result = oscc_priority_write( context, frames, 3 );
 
 
     return result;
 }
 
-oscc_result_t oscc_publish_steering_torque( double torque )
+oscc_result_t oscc_context_disable( oscc_context_t * context )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    oscc_steering_command_s steering_cmd =
+    oscc_brake_disable_s brake_disable =
     {
         .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
         .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
     };
 
-    steering_cmd.torque_command = (float) torque;
+    oscc_throttle_disable_s throttle_disable =
+    {
+        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
+        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
+    };
+
+    oscc_steering_disable_s steering_disable =
+    {
+        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
+        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
+    };
+
+    struct can_frame frames[3];
 
-    result = oscc_can_write(
-        OSCC_STEERING_COMMAND_CAN_ID,
-        (void *) &steering_cmd,
-        sizeof(steering_cmd) );
+    oscc_build_frame( &frames[0], OSCC_BRAKE_DISABLE_CAN_ID, &brake_disable, sizeof(brake_disable) );
+    oscc_build_frame( &frames[1], OSCC_THROTTLE_DISABLE_CAN_ID, &throttle_disable, sizeof(throttle_disable) );
+    oscc_build_frame( &frames[2], OSCC_STEERING_DISABLE_CAN_ID, &steering_disable, sizeof(steering_disable) );
+
+    // Commands still waiting for the scheduler must not follow the disable
+    (void) oscc_context_flush_commands( context );
+
+    result = oscc_priority_write( context, frames, 3 );
 
 
     return result;
 }
 
-oscc_result_t oscc_subscribe_to_brake_reports( void (*callback)(oscc_brake_report_s *report) )
+oscc_result_t oscc_context_enable_confirmed(
+    oscc_context_t * context,
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    if ( callback != NULL )
+    if ( context != NULL )
     {
-        brake_report_callback = callback;
-        result = OSCC_OK;
+        result = oscc_confirm_state_change( context, true, timeout_ms, confirmation );
     }
 
 
     return result;
 }
 
-oscc_result_t oscc_subscribe_to_throttle_reports( void (*callback)(oscc_throttle_report_s *report) )
+oscc_result_t oscc_context_disable_confirmed(
+    oscc_context_t * context,
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    if ( callback != NULL )
+    if ( context != NULL )
     {
-        throttle_report_callback = callback;
-        result = OSCC_OK;
+        result = oscc_confirm_state_change( context, false, timeout_ms, confirmation );
     }
 
 
     return result;
 }
 
-oscc_result_t oscc_subscribe_to_steering_reports( void (*callback)(oscc_steering_report_s *report))
+oscc_result_t oscc_context_publish_brake_position( oscc_context_t * context, double brake_position )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    if ( callback != NULL )
-    {
-        steering_report_callback = callback;
-        result = OSCC_OK;
-    }
+    const transmit_slot_t slot = TRANSMIT_SLOT_BRAKE;
+
+    result = oscc_publish_frames( context, &slot, &brake_position, 1 );
 
 
     return result;
 }
 
-oscc_result_t oscc_subscribe_to_fault_reports( void (*callback)(oscc_fault_report_s *report))
+oscc_result_t oscc_context_publish_throttle_position( oscc_context_t * context, double throttle_position )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    if ( callback != NULL )
-    {
-        fault_report_callback = callback;
-        result = OSCC_OK;
-    }
+    const transmit_slot_t slot = TRANSMIT_SLOT_THROTTLE;
+
+    result = oscc_publish_frames( context, &slot, &throttle_position, 1 );
 
 
     return result;
 }
 
-oscc_result_t oscc_subscribe_to_obd_messages( void (*callback)(struct can_frame *frame))
+oscc_result_t oscc_context_publish_steering_torque( oscc_context_t * context, double torque )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    if ( callback != NULL )
-    {
-        obd_frame_callback = callback;
-        result = OSCC_OK;
-    }
+    const transmit_slot_t slot = TRANSMIT_SLOT_STEERING;
+
+    result = oscc_publish_frames( context, &slot, &torque, 1 );
 
 
     return result;
 }
 
-
-
-
-/* Internal */
-oscc_result_t oscc_enable_brakes( void )
+oscc_result_t oscc_context_publish_commands(
+    oscc_context_t * context,
+    const oscc_command_set_s * commands )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    oscc_brake_enable_s brake_enable =
+    if ( commands != NULL )
     {
-        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
-        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
-    };
+        transmit_slot_t slots[TRANSMIT_SLOT_COUNT];
+        double values[TRANSMIT_SLOT_COUNT];
+        unsigned int count = 0;
+
+        if ( commands->publish_brake == true )
+        {
+            slots[count] = TRANSMIT_SLOT_BRAKE;
+            values[count++] = commands->brake_position;
+        }
+
+        if ( commands->publish_throttle == true )
+        {
+            slots[count] = TRANSMIT_SLOT_THROTTLE;
+            values[count++] = commands->throttle_position;
+        }
+
+        if ( commands->publish_steering == true )
+        {
+            slots[count] = TRANSMIT_SLOT_STEERING;
+            values[count++] = commands->steering_torque;
+        }
 
-    result = oscc_can_write(
-        OSCC_BRAKE_ENABLE_CAN_ID,
-        (void *) &brake_enable,
-        sizeof(brake_enable) );
+        if ( count > 0 )
+        {
+            result = oscc_publish_frames( context, slots, values, count );
+        }
+    }
 
 
     return result;
 }
 
-oscc_result_t oscc_enable_throttle( void )
+oscc_result_t oscc_context_subscribe_to_brake_reports(
+    oscc_context_t * context,
+    void (*callback)(oscc_brake_report_s *report) )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    oscc_throttle_enable_s throttle_enable =
+    if ( (context != NULL) && (callback != NULL) )
     {
-        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
-        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
-    };
-
-    result = oscc_can_write(
-        OSCC_THROTTLE_ENABLE_CAN_ID,
-        (void *) &throttle_enable,
-        sizeof(throttle_enable) );
+        context->callbacks.brake_report = callback;
+        result = oscc_update_can_filters( context );
+    }
 
 
     return result;
 }
 
-oscc_result_t oscc_enable_steering( void )
+oscc_result_t oscc_context_subscribe_to_throttle_reports(
+    oscc_context_t * context,
+    void (*callback)(oscc_throttle_report_s *report) )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    oscc_steering_enable_s steering_enable =
+    if ( (context != NULL) && (callback != NULL) )
     {
-        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
-        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
-    };
-
-    result = oscc_can_write(
-        OSCC_STEERING_ENABLE_CAN_ID,
-        (void *) &steering_enable,
-        sizeof(steering_enable) );
+        context->callbacks.throttle_report = callback;
+        result = oscc_update_can_filters( context );
+    }
 
 
     return result;
 }
 
-oscc_result_t oscc_disable_brakes( void )
+oscc_result_t oscc_context_subscribe_to_steering_reports(
+    oscc_context_t * context,
+    void (*callback)(oscc_steering_report_s *report) )
 {
     oscc_result_t result = OSCC_ERROR;
 
 
-    oscc_brake_disable_s brake_disable =
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.steering_report = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_fault_reports(
+    oscc_context_t * context,
+    void (*callback)(oscc_fault_report_s *report) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.fault_report = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_obd_messages(
+    oscc_context_t * context,
+    void (*callback)(struct can_frame *frame) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.obd_frame = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_brake_reports_timestamped(
+    oscc_context_t * context,
+    void (*callback)(oscc_brake_report_s *report, const struct timespec *timestamp) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.brake_report_timestamped = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_throttle_reports_timestamped(
+    oscc_context_t * context,
+    void (*callback)(oscc_throttle_report_s *report, const struct timespec *timestamp) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.throttle_report_timestamped = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_steering_reports_timestamped(
+    oscc_context_t * context,
+    void (*callback)(oscc_steering_report_s *report, const struct timespec *timestamp) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.steering_report_timestamped = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_fault_reports_timestamped(
+    oscc_context_t * context,
+    void (*callback)(oscc_fault_report_s *report, const struct timespec *timestamp) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.fault_report_timestamped = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_obd_messages_timestamped(
+    oscc_context_t * context,
+    void (*callback)(struct can_frame *frame, const struct timespec *timestamp) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.obd_frame_timestamped = callback;
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_report_watchdog(
+    oscc_context_t * context,
+    double period_multiple,
+    bool auto_disable )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && ((period_multiple == 0.0) || (period_multiple >= 1.0))
+        && (context->oscc_can_socket < 0)
+        && (context->report_watchdog.started == false) )
+    {
+        context->report_watchdog.period_multiple = period_multiple;
+        context->report_watchdog.auto_disable = auto_disable;
+
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_stale_reports(
+    oscc_context_t * context,
+    void (*callback)(oscc_report_stream_t stream) )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (callback != NULL) )
+    {
+        context->callbacks.report_stale = callback;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_obd_message_filter(
+    oscc_context_t * context,
+    const canid_t * can_ids,
+    unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    if ( context == NULL )
+    {
+        return result;
+    }
+
+    if ( (can_ids == NULL) || (count <= OSCC_OBD_FILTER_SIZE_MAX) )
+    {
+        // Another thread may be installing filters from the current set
+        pthread_mutex_lock( &context->filter_lock );
+
+        if ( can_ids == NULL )
+        {
+            context->obd_filter.enabled = false;
+            context->obd_filter.size = 0;
+        }
+        else
+        {
+            memcpy( context->obd_filter.ids, can_ids, count * sizeof(can_ids[0]) );
+            context->obd_filter.size = count;
+            context->obd_filter.enabled = true;
+        }
+
+        pthread_mutex_unlock( &context->filter_lock );
+
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_subscribe_to_can_id(
+    oscc_context_t * context,
+    canid_t can_id,
+    oscc_can_id_handler_t handler,
+    void * user_data )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (can_id < CAN_DISPATCH_TABLE_SIZE) )
+    {
+        dispatch_entry_s * const entry = &context->dispatch_table[can_id];
+
+        const can_id_subscription_s subscription =
+        {
+            .handler = handler,
+            .user_data = user_data
+        };
+
+        sigset_t sigio;
+        sigset_t previous;
+
+        sigemptyset( &sigio );
+        sigaddset( &sigio, SIGIO );
+
+        // The dispatch thread must never pair a handler with the user data
+        // of another subscription. A SIGIO handler interrupting the write on
+        // this thread would wait forever for it to finish.
+        pthread_mutex_lock( &context->filter_lock );
+        pthread_sigmask( SIG_BLOCK, &sigio, &previous );
+
+        seqlock_write(
+            &entry->subscription_lock,
+            &entry->subscription,
+            &subscription,
+            sizeof(subscription) );
+
+        pthread_sigmask( SIG_SETMASK, &previous, NULL );
+        pthread_mutex_unlock( &context->filter_lock );
+
+        result = oscc_update_can_filters( context );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_receive_mode(
+    oscc_context_t * context,
+    oscc_receive_mode_t mode )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0)
+        && (context->receive_engine.started == false) )
+    {
+        context->receive_mode = mode;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_receive_realtime(
+    oscc_context_t * context,
+    int priority,
+    int cpu,
+    bool lock_memory )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && ((priority == 0)
+            || ((priority >= sched_get_priority_min( SCHED_FIFO ))
+                && (priority <= sched_get_priority_max( SCHED_FIFO ))))
+        && (cpu >= -1)
+        && (cpu < CPU_SETSIZE)
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0)
+        && (context->receive_engine.started == false) )
+    {
+        context->receive_engine.priority = priority;
+        context->receive_engine.cpu = cpu;
+        context->receive_engine.lock_memory = lock_memory;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_io_backend(
+    oscc_context_t * context,
+    oscc_io_backend_t backend )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && ((backend == OSCC_IO_BACKEND_EPOLL) || (backend == OSCC_IO_BACKEND_IO_URING))
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0)
+        && (context->receive_engine.started == false) )
+    {
+        context->receive_engine.io_backend = backend;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_io_backend(
+    oscc_context_t * context,
+    oscc_io_backend_t * backend )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (backend != NULL)
+        && (context->receive_engine.started == true)
+        && (context->receive_mode == OSCC_RECEIVE_MODE_THREAD) )
+    {
+        *backend = ( context->receive_engine.io_ring_active == true )
+            ? OSCC_IO_BACKEND_IO_URING
+            : OSCC_IO_BACKEND_EPOLL;
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_busy_poll(
+    oscc_context_t * context,
+    const oscc_busy_poll_s * busy_poll )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (busy_poll != NULL)
+        && ((busy_poll->backoff == OSCC_BUSY_POLL_BACKOFF_NONE)
+            || (busy_poll->backoff == OSCC_BUSY_POLL_BACKOFF_YIELD)
+            || ((busy_poll->backoff == OSCC_BUSY_POLL_BACKOFF_SLEEP)
+                && (busy_poll->backoff_ns > 0)
+                && (busy_poll->backoff_ns < 1000000000)))
+        && (busy_poll->socket_busy_poll_us <= INT_MAX)
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0)
+        && (context->receive_engine.started == false) )
+    {
+        context->receive_engine.busy_poll = *busy_poll;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_fds(
+    oscc_context_t * context,
+    int * fds,
+    unsigned int * count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (fds != NULL)
+        && (count != NULL)
+        && (*count >= OSCC_FD_COUNT_MAX)
+        && (context->oscc_can_socket >= 0) )
+    {
+        unsigned int written = 0;
+
+        fds[written++] = context->oscc_can_socket;
+
+        if ( context->vehicle_can_socket >= 0 )
+        {
+            fds[written++] = context->vehicle_can_socket;
+        }
+
+        *count = written;
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_process_pending(
+    oscc_context_t * context,
+    unsigned int max_frames,
+    unsigned int * frames_processed )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    unsigned int processed = 0;
+
+
+    if ( (context != NULL) && (context->receive_mode == OSCC_RECEIVE_MODE_EXTERNAL) )
+    {
+        if ( max_frames == 0 )
+        {
+            max_frames = UINT_MAX;
+        }
+
+        // Reports are handled ahead of the vehicle's OBD traffic
+        if ( context->oscc_can_socket >= 0 )
+        {
+            processed += oscc_drain_socket(
+                context,
+                context->oscc_can_socket,
+                OSCC_CAN_BUS_OSCC,
+                oscc_dispatch_frame,
+                max_frames );
+        }
+
+        if ( context->vehicle_can_socket >= 0 )
+        {
+            processed += oscc_drain_socket(
+                context,
+                context->vehicle_can_socket,
+                OSCC_CAN_BUS_VEHICLE,
+                oscc_dispatch_frame,
+                max_frames - processed );
+        }
+
+        result = OSCC_OK;
+    }
+
+    if ( frames_processed != NULL )
+    {
+        *frames_processed = processed;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_receive_batch_size(
+    oscc_context_t * context,
+    unsigned int size )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (size > 0) && (size <= OSCC_RECEIVE_BATCH_SIZE_MAX) )
+    {
+        context->receive_batch.size = size;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_receive_counters(
+    oscc_context_t * context,
+    oscc_receive_counters_s * counters )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (counters != NULL) )
+    {
+        counters->syscalls = atomic_load_explicit(
+            &context->receive_batch.syscalls,
+            memory_order_relaxed );
+
+        counters->frames = atomic_load_explicit(
+            &context->receive_batch.frames_received,
+            memory_order_relaxed );
+
+        counters->frames_per_syscall = 0.0;
+
+        if ( counters->syscalls > 0 )
+        {
+            counters->frames_per_syscall =
+                (double) counters->frames / (double) counters->syscalls;
+        }
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_can_id_counters(
+    oscc_context_t * context,
+    oscc_can_bus_t bus,
+    canid_t can_id,
+    oscc_can_id_counters_s * counters )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (bus < OSCC_CAN_BUS_COUNT)
+        && ((can_id <= CAN_SFF_MASK) || (can_id == CAN_EFF_FLAG))
+        && (counters != NULL) )
+    {
+        const bus_counters_s * const bus_counters = &context->bus_counters[bus];
+
+        const can_id_counters_s * const source =
+            ( can_id == CAN_EFF_FLAG ) ? &bus_counters->extended : &bus_counters->ids[can_id];
+
+        const uint64_t last_seen_ns = atomic_load_explicit( &source->last_seen_ns, memory_order_relaxed );
+
+        counters->frames = atomic_load_explicit( &source->frames, memory_order_relaxed );
+        counters->bytes = atomic_load_explicit( &source->bytes, memory_order_relaxed );
+        counters->drops = atomic_load_explicit( &source->drops, memory_order_relaxed );
+        counters->last_seen.tv_sec = last_seen_ns / 1000000000;
+        counters->last_seen.tv_nsec = last_seen_ns % 1000000000;
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_bus_stats(
+    oscc_context_t * context,
+    oscc_can_bus_t bus,
+    oscc_bus_stats_s * stats )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (bus < OSCC_CAN_BUS_COUNT) && (stats != NULL) )
+    {
+        const bus_counters_s * const bus_counters = &context->bus_counters[bus];
+
+        unsigned int i;
+
+        memset( stats, 0, sizeof(*stats) );
+
+        for ( i = 0; i <= CAN_DISPATCH_TABLE_SIZE; i++ )
+        {
+            const can_id_counters_s * const counters =
+                ( i < CAN_DISPATCH_TABLE_SIZE ) ? &bus_counters->ids[i] : &bus_counters->extended;
+
+            stats->frames += atomic_load_explicit( &counters->frames, memory_order_relaxed );
+            stats->bytes += atomic_load_explicit( &counters->bytes, memory_order_relaxed );
+            stats->drops += atomic_load_explicit( &counters->drops, memory_order_relaxed );
+        }
+
+        uint64_t load_ppm;
+
+        // The interface counts every frame on the bus, the sockets only those
+        // the filters let through. Replayed frames have no interface.
+        if ( oscc_sample_interface_load( context, bus, &load_ppm ) == false )
+        {
+            load_ppm = atomic_load_explicit( &bus_counters->load_ppm, memory_order_relaxed );
+        }
+
+        stats->bits = atomic_load_explicit( &bus_counters->bits, memory_order_relaxed );
+        stats->load = load_ppm / 1e6;
+        stats->overflows = atomic_load_explicit( &bus_counters->overflows, memory_order_relaxed );
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_start_recording(
+    oscc_context_t * context,
+    const char * path )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (path != NULL)
+        && (atomic_load( &context->recorder.fd ) < 0) )
+    {
+        int fd = open( path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+
+        if ( fd < 0 )
+        {
+            perror( "Opening frame log failed:" );
+        }
+        else if ( oscc_frame_log_prepare( fd ) != OSCC_OK )
+        {
+            printf( "Error: %s is not a frame log\n", path );
+
+            close( fd );
+        }
+        else
+        {
+            int expected = -1;
+
+            if ( atomic_compare_exchange_strong( &context->recorder.fd, &expected, fd ) )
+            {
+                result = OSCC_OK;
+            }
+            else
+            {
+                // Another thread started recording first
+                close( fd );
+            }
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_stop_recording( oscc_context_t * context )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( context != NULL )
+    {
+        frame_recorder_s * const recorder = &context->recorder;
+
+        const int fd = atomic_exchange( &recorder->fd, -1 );
+
+        if ( fd < 0 )
+        {
+            result = OSCC_WARNING;
+        }
+        else
+        {
+            // Batches that saw the descriptor before it was cleared finish
+            // writing before it is closed
+            while ( atomic_load( &recorder->writers ) > 0 )
+            {
+                sched_yield( );
+            }
+
+            close( fd );
+
+            result = OSCC_OK;
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_replay(
+    oscc_context_t * context,
+    const char * path,
+    double speed )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (path != NULL)
+        && (speed >= 0.0)
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0) )
+    {
+        int fd = open( path, O_RDONLY | O_CLOEXEC );
+
+        struct stat file_stat;
+
+        if ( fd < 0 )
+        {
+            perror( "Opening frame log failed:" );
+        }
+        else if ( (fstat( fd, &file_stat ) < 0)
+            || ((size_t) file_stat.st_size < sizeof(frame_log_header_s)) )
+        {
+            printf( "Error: %s is not a frame log\n", path );
+        }
+        else
+        {
+            const size_t size = (size_t) file_stat.st_size;
+
+            const uint8_t * const mapping = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+            if ( mapping == MAP_FAILED )
+            {
+                perror( "Mapping frame log failed:" );
+            }
+            else
+            {
+                const frame_log_header_s * const header = (const frame_log_header_s *) mapping;
+
+                if ( (header->magic != FRAME_LOG_MAGIC)
+                    || (header->version != FRAME_LOG_VERSION)
+                    || (header->record_size != sizeof(frame_log_record_s)) )
+                {
+                    printf( "Error: %s is not a compatible frame log\n", path );
+                }
+                else
+                {
+                    const frame_log_record_s * const records =
+                        (const frame_log_record_s *) ( mapping + sizeof(*header) );
+
+                    // A record cut short by a crash is left out
+                    const size_t count = ( size - sizeof(*header) ) / sizeof(records[0]);
+
+                    struct timespec start;
+
+                    size_t i;
+
+                    (void) madvise( (void *) mapping, size, MADV_SEQUENTIAL );
+
+                    // Replay needs the same routing as opening would set up
+                    oscc_map_obd_frames( context );
+
+                    clock_gettime( CLOCK_MONOTONIC, &start );
+
+                    for ( i = 0; i < count; i++ )
+                    {
+                        const frame_log_record_s * const record = &records[i];
+
+                        if ( record->bus >= OSCC_CAN_BUS_COUNT )
+                        {
+                            continue;
+                        }
+
+                        if ( speed > 0.0 )
+                        {
+                            // Timestamps that go backwards replay straight away
+                            const double offset_ns =
+                                (double) (int64_t) ( record->timestamp_ns - records[0].timestamp_ns ) / speed;
+
+                            if ( offset_ns > 0.0 )
+                            {
+                                const uint64_t due_ns =
+                                    ( (uint64_t) start.tv_sec * UINT64_C(1000000000) )
+                                    + (uint64_t) start.tv_nsec
+                                    + (uint64_t) offset_ns;
+
+                                const struct timespec due =
+                                {
+                                    .tv_sec = due_ns / 1000000000,
+                                    .tv_nsec = due_ns % 1000000000
+                                };
+
+                                while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL ) == EINTR )
+                                {
+                                }
+                            }
+                        }
+
+                        oscc_rx_frame_s rx_frame =
+                        {
+                            .frame = record->frame,
+                            .timestamp =
+                            {
+                                .tv_sec = record->timestamp_ns / 1000000000,
+                                .tv_nsec = record->timestamp_ns % 1000000000
+                            },
+                            .bus = (oscc_can_bus_t) record->bus
+                        };
+
+                        oscc_count_frame( context, &rx_frame );
+
+                        oscc_dispatch_frame( context, &rx_frame );
+                    }
+
+                    result = OSCC_OK;
+                }
+
+                munmap( (void *) mapping, size );
+            }
+        }
+
+        if ( fd >= 0 )
+        {
+            close( fd );
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_transmit_rate(
+    oscc_context_t * context,
+    unsigned int rate )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (rate <= OSCC_TRANSMIT_RATE_MAX)
+        && (context->oscc_can_socket < 0)
+        && (context->transmit_scheduler.started == false) )
+    {
+        context->transmit_scheduler.rate = rate;
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_flush_commands( oscc_context_t * context )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( context != NULL )
+    {
+        unsigned int i;
+
+        for ( i = 0; i < TRANSMIT_SLOT_COUNT; i++ )
+        {
+            atomic_fetch_and( &context->transmit_scheduler.slots[i], ~TRANSMIT_SLOT_PENDING );
+        }
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_priority_latency(
+    oscc_context_t * context,
+    oscc_priority_latency_s * latency )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (latency != NULL) )
+    {
+        priority_lane_s * const lane = &context->priority_lane;
+
+        pthread_mutex_lock( &lane->lock );
+
+        oscc_priority_lane_drain( context );
+
+        latency->last_ns = lane->last_ns;
+        latency->worst_ns = lane->worst_ns;
+        latency->requests = lane->measured;
+
+        pthread_mutex_unlock( &lane->lock );
+
+        result = ( latency->requests > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_stats(
+    oscc_context_t * context,
+    oscc_stats_s * stats )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+#ifdef OSCC_STATS
+    if ( (context != NULL) && (stats != NULL) )
+    {
+        const stats_s * const source = &context->stats;
+
+        unsigned int i;
+        unsigned int j;
+
+        memset( stats, 0, sizeof(*stats) );
+
+        memcpy( stats->bounds_ns, source->bounds_ns, source->bound_count * sizeof(source->bounds_ns[0]) );
+        stats->bucket_count = source->bound_count + 1;
+
+        for ( i = 0; i < OSCC_STATS_HISTOGRAM_COUNT; i++ )
+        {
+            const stats_histogram_s * const histogram = &source->histograms[i];
+
+            for ( j = 0; j < stats->bucket_count; j++ )
+            {
+                stats->histograms[i].counts[j] = atomic_load_explicit( &histogram->counts[j], memory_order_relaxed );
+            }
+
+            stats->histograms[i].samples = atomic_load_explicit( &histogram->samples, memory_order_relaxed );
+            stats->histograms[i].total_ns = atomic_load_explicit( &histogram->total_ns, memory_order_relaxed );
+            stats->histograms[i].min_ns = atomic_load_explicit( &histogram->min_ns, memory_order_relaxed );
+            stats->histograms[i].max_ns = atomic_load_explicit( &histogram->max_ns, memory_order_relaxed );
+        }
+
+        result = OSCC_OK;
+    }
+#else
+    (void) context;
+    (void) stats;
+#endif
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_reset_stats( oscc_context_t * context )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+#ifdef OSCC_STATS
+    if ( context != NULL )
+    {
+        stats_s * const stats = &context->stats;
+
+        unsigned int i;
+        unsigned int j;
+
+        for ( i = 0; i < OSCC_STATS_HISTOGRAM_COUNT; i++ )
+        {
+            stats_histogram_s * const histogram = &stats->histograms[i];
+
+            for ( j = 0; j < OSCC_STATS_BUCKET_COUNT; j++ )
+            {
+                atomic_store_explicit( &histogram->counts[j], 0, memory_order_relaxed );
+            }
+
+            atomic_store_explicit( &histogram->samples, 0, memory_order_relaxed );
+            atomic_store_explicit( &histogram->total_ns, 0, memory_order_relaxed );
+            atomic_store_explicit( &histogram->min_ns, 0, memory_order_relaxed );
+            atomic_store_explicit( &histogram->max_ns, 0, memory_order_relaxed );
+            atomic_store_explicit( &stats->marks_ns[i], 0, memory_order_relaxed );
+        }
+
+        result = OSCC_OK;
+    }
+#else
+    (void) context;
+#endif
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_stats_bounds(
+    oscc_context_t * context,
+    const uint64_t * bounds_ns,
+    unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+#ifdef OSCC_STATS
+    if ( (context != NULL)
+        && (bounds_ns != NULL)
+        && (count > 0)
+        && (count <= STATS_BOUNDS_MAX)
+        && (context->oscc_can_socket < 0) )
+    {
+        unsigned int i;
+
+        for ( i = 1; (i < count) && (bounds_ns[i] > bounds_ns[i - 1]); i++ )
+        {
+        }
+
+        if ( i == count )
+        {
+            memcpy( context->stats.bounds_ns, bounds_ns, count * sizeof(bounds_ns[0]) );
+            context->stats.bound_count = count;
+
+            result = oscc_context_reset_stats( context );
+        }
+    }
+#else
+    (void) context;
+    (void) bounds_ns;
+    (void) count;
+#endif
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_print_stats(
+    oscc_context_t * context,
+    FILE * stream )
+{
+    static const char * const names[OSCC_STATS_HISTOGRAM_COUNT] =
+    {
+        [OSCC_STATS_BRAKE_REPORT_INTERVAL] = "brake report interval",
+        [OSCC_STATS_STEERING_REPORT_INTERVAL] = "steering report interval",
+        [OSCC_STATS_THROTTLE_REPORT_INTERVAL] = "throttle report interval",
+        [OSCC_STATS_FAULT_REPORT_INTERVAL] = "fault report interval",
+        [OSCC_STATS_BRAKE_COMMAND_TO_REPORT] = "brake command to report",
+        [OSCC_STATS_THROTTLE_COMMAND_TO_REPORT] = "throttle command to report",
+        [OSCC_STATS_STEERING_COMMAND_TO_REPORT] = "steering command to report",
+        [OSCC_STATS_RECEIVE_TO_CALLBACK] = "receive to callback",
+        [OSCC_STATS_DISPATCH] = "dispatch",
+        [OSCC_STATS_WRITE] = "write"
+    };
+
+    oscc_result_t result = OSCC_ERROR;
+
+    oscc_stats_s stats;
+
+
+    if ( (stream != NULL) && (oscc_context_get_stats( context, &stats ) == OSCC_OK) )
+    {
+        int written = 0;
+
+        unsigned int i;
+        unsigned int j;
+
+        for ( i = 0; (i < OSCC_STATS_HISTOGRAM_COUNT) && (written >= 0); i++ )
+        {
+            const oscc_histogram_s * const histogram = &stats.histograms[i];
+
+            if ( histogram->samples == 0 )
+            {
+                written = fprintf( stream, "%s: no samples\n", names[i] );
+
+                continue;
+            }
+
+            written = fprintf(
+                stream,
+                "%s: %llu samples, min %.3f us, mean %.3f us, max %.3f us\n",
+                names[i],
+                (unsigned long long) histogram->samples,
+                histogram->min_ns / 1000.0,
+                ( (double) histogram->total_ns / histogram->samples ) / 1000.0,
+                histogram->max_ns / 1000.0 );
+
+            for ( j = 0; (j < stats.bucket_count) && (written >= 0); j++ )
+            {
+                if ( histogram->counts[j] == 0 )
+                {
+                    continue;
+                }
+
+                if ( j < (stats.bucket_count - 1) )
+                {
+                    written = fprintf(
+                        stream,
+                        "    <= %.3f us: %llu\n",
+                        stats.bounds_ns[j] / 1000.0,
+                        (unsigned long long) histogram->counts[j] );
+                }
+                else
+                {
+                    written = fprintf(
+                        stream,
+                        "    >  %.3f us: %llu\n",
+                        stats.bounds_ns[j - 1] / 1000.0,
+                        (unsigned long long) histogram->counts[j] );
+                }
+            }
+        }
+
+        if ( written >= 0 )
+        {
+            result = OSCC_OK;
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_receive_threads(
+    oscc_context_t * context,
+    pthread_t * receive_thread,
+    pthread_t * dispatch_thread )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (context->receive_engine.started == true) )
+    {
+        if ( receive_thread != NULL )
+        {
+            *receive_thread = context->receive_engine.receive_thread;
+        }
+
+        if ( dispatch_thread != NULL )
+        {
+            *dispatch_thread = context->receive_engine.dispatch_thread;
+        }
+
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_track_snapshots( oscc_context_t * context )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( context != NULL )
+    {
+        result = OSCC_OK;
+
+        if ( atomic_exchange( &context->snapshots_enabled, true ) == false )
+        {
+            result = oscc_update_can_filters( context );
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_latest_brake_report(
+    oscc_context_t * context,
+    oscc_brake_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (snapshot != NULL) )
+    {
+        const brake_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->brake;
+
+        seqlock_read( &slot->lock, snapshot, &slot->snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_latest_steering_report(
+    oscc_context_t * context,
+    oscc_steering_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (snapshot != NULL) )
+    {
+        const steering_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->steering;
+
+        seqlock_read( &slot->lock, snapshot, &slot->snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_latest_throttle_report(
+    oscc_context_t * context,
+    oscc_throttle_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (snapshot != NULL) )
+    {
+        const throttle_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->throttle;
+
+        seqlock_read( &slot->lock, snapshot, &slot->snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_latest_fault_report(
+    oscc_context_t * context,
+    oscc_fault_report_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (snapshot != NULL) )
+    {
+        const fault_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->fault;
+
+        seqlock_read( &slot->lock, snapshot, &slot->snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_get_latest_obd_values(
+    oscc_context_t * context,
+    oscc_obd_snapshot_s * snapshot )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (snapshot != NULL) )
+    {
+        const obd_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->obd;
+
+        seqlock_read( &slot->lock, snapshot, &slot->snapshot, sizeof(*snapshot) );
+
+        result = ( snapshot->sequence > 0 ) ? OSCC_OK : OSCC_WARNING;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_set_vehicle(
+    oscc_context_t * context,
+    oscc_vehicle_t vehicle )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && ((unsigned int) vehicle < OSCC_VEHICLE_COUNT)
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0)
+        && (context->receive_engine.started == false) )
+    {
+        context->obd_vehicle = global_obd_vehicles[vehicle];
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_decode_obd_frame(
+    const oscc_context_t * context,
+    const struct can_frame * frame,
+    double * values,
+    unsigned int * decoded )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (frame != NULL) && (values != NULL) && (decoded != NULL) )
+    {
+        const obd_frame_s * const obd_frame =
+            obd_vehicle_frame( context->obd_vehicle, frame->can_id );
+
+        if ( obd_frame != NULL )
+        {
+            *decoded = obd_frame_decode( obd_frame, frame, values );
+            result = OSCC_OK;
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_decode_wheel_speeds(
+    const oscc_context_t * context,
+    const struct can_frame * frame,
+    double * wheel_speeds )
+{
+    return oscc_context_decode_wheel_speeds_array( context, frame, 1, wheel_speeds );
+}
+
+oscc_result_t oscc_context_decode_wheel_speeds_array(
+    const oscc_context_t * context,
+    const struct can_frame * frames,
+    size_t count,
+    double * wheel_speeds )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL) && (frames != NULL) && (wheel_speeds != NULL) )
+    {
+        const obd_frame_s * const obd_frame = obd_vehicle_signal_frame(
+            context->obd_vehicle,
+            OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT );
+
+        size_t i;
+
+        for ( i = 0; (obd_frame != NULL) && (i < count); i++ )
+        {
+            if ( frames[i].can_id != obd_frame->can_id )
+            {
+                break;
+            }
+        }
+
+        if ( (obd_frame != NULL) && (i == count) )
+        {
+            obd_frames_decode_wheel_speeds( obd_frame, frames, count, wheel_speeds );
+            result = OSCC_OK;
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_share_snapshots( oscc_context_t * context, const char * name )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (name != NULL)
+        && (strlen( name ) < NAME_MAX)
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0)
+        && (context->snapshots_mapping == NULL) )
+    {
+        int fd = shm_open( name, O_CREAT | O_RDWR | O_CLOEXEC, 0644 );
+
+        if ( fd < 0 )
+        {
+            perror( "Creating shared snapshots failed:" );
+        }
+        else
+        {
+            snapshot_store_s * mapping = MAP_FAILED;
+
+            if ( ftruncate( fd, sizeof(*mapping) ) == 0 )
+            {
+                mapping = mmap( NULL, sizeof(*mapping), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+            }
+
+            close( fd );
+
+            if ( mapping == MAP_FAILED )
+            {
+                perror( "Mapping shared snapshots failed:" );
+
+                shm_unlink( name );
+            }
+            else
+            {
+                memcpy( mapping, &context->snapshots, sizeof(*mapping) );
+
+                mapping->version = SNAPSHOT_STORE_VERSION;
+                mapping->size = sizeof(*mapping);
+
+                // Readers only trust the store once the magic is in place
+                atomic_thread_fence( memory_order_release );
+                mapping->magic = SNAPSHOT_STORE_MAGIC;
+
+                strcpy( context->snapshots_name, name );
+                context->snapshots_mapping = mapping;
+                context->snapshots_writable = true;
+
+                result = oscc_context_track_snapshots( context );
+            }
+        }
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_context_attach_snapshots( oscc_context_t * context, const char * name )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (context != NULL)
+        && (name != NULL)
+        && (context->oscc_can_socket < 0)
+        && (context->vehicle_can_socket < 0)
+        && (context->snapshots_mapping == NULL) )
+    {
+        int fd = shm_open( name, O_RDONLY | O_CLOEXEC, 0 );
+
+        struct stat status;
+
+        if ( fd < 0 )
+        {
+            perror( "Opening shared snapshots failed:" );
+        }
+        else if ( (fstat( fd, &status ) == 0)
+            && (status.st_size >= (off_t) sizeof(snapshot_store_s)) )
+        {
+            snapshot_store_s * mapping =
+                mmap( NULL, sizeof(*mapping), PROT_READ, MAP_SHARED, fd, 0 );
+
+            if ( mapping == MAP_FAILED )
+            {
+                perror( "Mapping shared snapshots failed:" );
+            }
+            else if ( (mapping->magic != SNAPSHOT_STORE_MAGIC)
+                || (mapping->version != SNAPSHOT_STORE_VERSION)
+                || (mapping->size != sizeof(*mapping)) )
+            {
+                printf( "Error: Shared snapshots %s are not compatible\n", name );
+
+                munmap( mapping, sizeof(*mapping) );
+            }
+            else
+            {
+                context->snapshots_name[0] = '\0';
+                context->snapshots_mapping = mapping;
+                context->snapshots_writable = false;
+
+                result = OSCC_OK;
+            }
+        }
+
+        if ( fd >= 0 )
+        {
+            close( fd );
+        }
+    }
+
+
+    return result;
+}
+
+
+
+
+/* Default context */
+oscc_result_t oscc_init()
+{
+    return oscc_context_init( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_open( unsigned int channel )
+{
+    return oscc_context_open( oscc_default_context( ), channel );
+}
+
+oscc_result_t oscc_close( unsigned int channel )
+{
+    return oscc_context_close( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_enable( void )
+{
+    return oscc_context_enable( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_disable( void )
+{
+    return oscc_context_disable( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_enable_confirmed(
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation )
+{
+    return oscc_context_enable_confirmed( oscc_default_context( ), timeout_ms, confirmation );
+}
+
+oscc_result_t oscc_disable_confirmed(
+    unsigned int timeout_ms,
+    oscc_confirmation_s * confirmation )
+{
+    return oscc_context_disable_confirmed( oscc_default_context( ), timeout_ms, confirmation );
+}
+
+oscc_result_t oscc_publish_brake_position( double brake_position )
+{
+    return oscc_context_publish_brake_position( oscc_default_context( ), brake_position );
+}
+
+oscc_result_t oscc_publish_throttle_position( double throttle_position )
+{
+    return oscc_context_publish_throttle_position( oscc_default_context( ), throttle_position );
+}
+
+oscc_result_t oscc_publish_steering_torque( double torque )
+{
+    return oscc_context_publish_steering_torque( oscc_default_context( ), torque );
+}
+
+oscc_result_t oscc_publish_commands( const oscc_command_set_s * commands )
+{
+    return oscc_context_publish_commands( oscc_default_context( ), commands );
+}
+
+oscc_result_t oscc_subscribe_to_brake_reports(
+    void (*callback)(oscc_brake_report_s *report) )
+{
+    return oscc_context_subscribe_to_brake_reports( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_throttle_reports(
+    void (*callback)(oscc_throttle_report_s *report) )
+{
+    return oscc_context_subscribe_to_throttle_reports( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_steering_reports(
+    void (*callback)(oscc_steering_report_s *report) )
+{
+    return oscc_context_subscribe_to_steering_reports( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_fault_reports(
+    void (*callback)(oscc_fault_report_s *report) )
+{
+    return oscc_context_subscribe_to_fault_reports( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_obd_messages(
+    void (*callback)(struct can_frame *frame) )
+{
+    return oscc_context_subscribe_to_obd_messages( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_brake_reports_timestamped(
+    void (*callback)(oscc_brake_report_s *report, const struct timespec *timestamp) )
+{
+    return oscc_context_subscribe_to_brake_reports_timestamped( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_throttle_reports_timestamped(
+    void (*callback)(oscc_throttle_report_s *report, const struct timespec *timestamp) )
+{
+    return oscc_context_subscribe_to_throttle_reports_timestamped( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_steering_reports_timestamped(
+    void (*callback)(oscc_steering_report_s *report, const struct timespec *timestamp) )
+{
+    return oscc_context_subscribe_to_steering_reports_timestamped( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_fault_reports_timestamped(
+    void (*callback)(oscc_fault_report_s *report, const struct timespec *timestamp) )
+{
+    return oscc_context_subscribe_to_fault_reports_timestamped( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_subscribe_to_obd_messages_timestamped(
+    void (*callback)(struct can_frame *frame, const struct timespec *timestamp) )
+{
+    return oscc_context_subscribe_to_obd_messages_timestamped( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_set_report_watchdog( double period_multiple, bool auto_disable )
+{
+    return oscc_context_set_report_watchdog( oscc_default_context( ), period_multiple, auto_disable );
+}
+
+oscc_result_t oscc_subscribe_to_stale_reports(
+    void (*callback)(oscc_report_stream_t stream) )
+{
+    return oscc_context_subscribe_to_stale_reports( oscc_default_context( ), callback );
+}
+
+oscc_result_t oscc_set_obd_message_filter( const canid_t * can_ids, unsigned int count )
+{
+    return oscc_context_set_obd_message_filter( oscc_default_context( ), can_ids, count );
+}
+
+oscc_result_t oscc_subscribe_to_can_id(
+    canid_t can_id,
+    oscc_can_id_handler_t handler,
+    void * user_data )
+{
+    return oscc_context_subscribe_to_can_id( oscc_default_context( ), can_id, handler, user_data );
+}
+
+oscc_result_t oscc_set_receive_mode( oscc_receive_mode_t mode )
+{
+    return oscc_context_set_receive_mode( oscc_default_context( ), mode );
+}
+
+oscc_result_t oscc_get_fds( int * fds, unsigned int * count )
+{
+    return oscc_context_get_fds( oscc_default_context( ), fds, count );
+}
+
+oscc_result_t oscc_process_pending(
+    unsigned int max_frames,
+    unsigned int * frames_processed )
+{
+    return oscc_context_process_pending( oscc_default_context( ), max_frames, frames_processed );
+}
+
+oscc_result_t oscc_set_receive_batch_size( unsigned int size )
+{
+    return oscc_context_set_receive_batch_size( oscc_default_context( ), size );
+}
+
+oscc_result_t oscc_get_receive_counters( oscc_receive_counters_s * counters )
+{
+    return oscc_context_get_receive_counters( oscc_default_context( ), counters );
+}
+
+oscc_result_t oscc_get_can_id_counters(
+    oscc_can_bus_t bus,
+    canid_t can_id,
+    oscc_can_id_counters_s * counters )
+{
+    return oscc_context_get_can_id_counters( oscc_default_context( ), bus, can_id, counters );
+}
+
+oscc_result_t oscc_get_bus_stats( oscc_can_bus_t bus, oscc_bus_stats_s * stats )
+{
+    return oscc_context_get_bus_stats( oscc_default_context( ), bus, stats );
+}
+
+oscc_result_t oscc_start_recording( const char * path )
+{
+    return oscc_context_start_recording( oscc_default_context( ), path );
+}
+
+oscc_result_t oscc_stop_recording( void )
+{
+    return oscc_context_stop_recording( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_replay( const char * path, double speed )
+{
+    return oscc_context_replay( oscc_default_context( ), path, speed );
+}
+
+oscc_result_t oscc_set_transmit_rate( unsigned int rate )
+{
+    return oscc_context_set_transmit_rate( oscc_default_context( ), rate );
+}
+
+oscc_result_t oscc_flush_commands( void )
+{
+    return oscc_context_flush_commands( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_get_priority_latency( oscc_priority_latency_s * latency )
+{
+    return oscc_context_get_priority_latency( oscc_default_context( ), latency );
+}
+
+oscc_result_t oscc_get_stats( oscc_stats_s * stats )
+{
+    return oscc_context_get_stats( oscc_default_context( ), stats );
+}
+
+oscc_result_t oscc_reset_stats( void )
+{
+    return oscc_context_reset_stats( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_set_stats_bounds( const uint64_t * bounds_ns, unsigned int count )
+{
+    return oscc_context_set_stats_bounds( oscc_default_context( ), bounds_ns, count );
+}
+
+oscc_result_t oscc_print_stats( FILE * stream )
+{
+    return oscc_context_print_stats( oscc_default_context( ), stream );
+}
+
+oscc_result_t oscc_get_receive_threads(
+    pthread_t * receive_thread,
+    pthread_t * dispatch_thread )
+{
+    return oscc_context_get_receive_threads( oscc_default_context( ), receive_thread, dispatch_thread );
+}
+
+oscc_result_t oscc_set_receive_realtime(
+    int priority,
+    int cpu,
+    bool lock_memory )
+{
+    return oscc_context_set_receive_realtime( oscc_default_context( ), priority, cpu, lock_memory );
+}
+
+oscc_result_t oscc_set_io_backend( oscc_io_backend_t backend )
+{
+    return oscc_context_set_io_backend( oscc_default_context( ), backend );
+}
+
+oscc_result_t oscc_get_io_backend( oscc_io_backend_t * backend )
+{
+    return oscc_context_get_io_backend( oscc_default_context( ), backend );
+}
+
+oscc_result_t oscc_set_busy_poll( const oscc_busy_poll_s * busy_poll )
+{
+    return oscc_context_set_busy_poll( oscc_default_context( ), busy_poll );
+}
+
+oscc_result_t oscc_track_snapshots( void )
+{
+    return oscc_context_track_snapshots( oscc_default_context( ) );
+}
+
+oscc_result_t oscc_get_latest_brake_report( oscc_brake_report_snapshot_s * snapshot )
+{
+    return oscc_context_get_latest_brake_report( oscc_default_context( ), snapshot );
+}
+
+oscc_result_t oscc_get_latest_steering_report( oscc_steering_report_snapshot_s * snapshot )
+{
+    return oscc_context_get_latest_steering_report( oscc_default_context( ), snapshot );
+}
+
+oscc_result_t oscc_get_latest_throttle_report( oscc_throttle_report_snapshot_s * snapshot )
+{
+    return oscc_context_get_latest_throttle_report( oscc_default_context( ), snapshot );
+}
+
+oscc_result_t oscc_get_latest_fault_report( oscc_fault_report_snapshot_s * snapshot )
+{
+    return oscc_context_get_latest_fault_report( oscc_default_context( ), snapshot );
+}
+
+oscc_result_t oscc_get_latest_obd_values( oscc_obd_snapshot_s * snapshot )
+{
+    return oscc_context_get_latest_obd_values( oscc_default_context( ), snapshot );
+}
+
+oscc_result_t oscc_set_vehicle( oscc_vehicle_t vehicle )
+{
+    return oscc_context_set_vehicle( oscc_default_context( ), vehicle );
+}
+
+oscc_result_t oscc_decode_obd_frame(
+    const struct can_frame * frame,
+    double * values,
+    unsigned int * decoded )
+{
+    return oscc_context_decode_obd_frame( oscc_decoding_context( ), frame, values, decoded );
+}
+
+oscc_result_t oscc_decode_wheel_speeds(
+    const struct can_frame * frame,
+    double * wheel_speeds )
+{
+    return oscc_context_decode_wheel_speeds( oscc_decoding_context( ), frame, wheel_speeds );
+}
+
+oscc_result_t oscc_decode_wheel_speeds_array(
+    const struct can_frame * frames,
+    size_t count,
+    double * wheel_speeds )
+{
+    return oscc_context_decode_wheel_speeds_array(
+        oscc_decoding_context( ),
+        frames,
+        count,
+        wheel_speeds );
+}
+
+
+
+
+/* Internal */
+void oscc_update_status( int sig, siginfo_t *siginfo, void *ucontext )
+{
+    atomic_fetch_add( &global_signal_handlers_active, 1 );
+
+    global_signal_handler_depth++;
+
+    // SIGIO does not say which socket is readable, so every context receiving
+    // through signals is drained
+    uint i;
+
+    for ( i = 0; i < OSCC_CONTEXT_COUNT_MAX; i++ )
+    {
+        oscc_context_t * const context = atomic_load( &global_contexts[i] );
+
+        if ( (context == NULL) || (context->receive_mode != OSCC_RECEIVE_MODE_SIGNAL) )
+        {
+            continue;
+        }
+
+        // Handlers on other threads may run at once, but only one may
+        // dispatch a context. The one holding it drains again for signals
+        // that arrived meanwhile, so a frame is never left behind.
+        atomic_store( &context->signal_drain_pending, true );
+
+        while ( (atomic_load( &context->signal_drain_pending ) == true)
+            && (atomic_flag_test_and_set( &context->signal_draining ) == false) )
+        {
+            atomic_store( &context->signal_drain_pending, false );
+
+            int socket = context->oscc_can_socket;
+
+            if ( socket >= 0 )
+            {
+                oscc_drain_socket(
+                    context,
+                    socket,
+                    OSCC_CAN_BUS_OSCC,
+                    oscc_dispatch_frame,
+                    UINT_MAX );
+            }
+
+            socket = context->vehicle_can_socket;
+
+            if ( socket >= 0 )
+            {
+                oscc_drain_socket(
+                    context,
+                    socket,
+                    OSCC_CAN_BUS_VEHICLE,
+                    oscc_dispatch_frame,
+                    UINT_MAX );
+            }
+
+            atomic_flag_clear( &context->signal_draining );
+        }
+    }
+
+    global_signal_handler_depth--;
+
+    atomic_fetch_sub( &global_signal_handlers_active, 1 );
+}
+
+oscc_result_t oscc_context_register( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    pthread_mutex_lock( &global_contexts_lock );
+
+    uint i;
+
+    for ( i = 0; (result != OSCC_OK) && (i < OSCC_CONTEXT_COUNT_MAX); i++ )
+    {
+        if ( atomic_load( &global_contexts[i] ) == NULL )
+        {
+            atomic_store( &global_contexts[i], context );
+            result = OSCC_OK;
+        }
+    }
+
+    pthread_mutex_unlock( &global_contexts_lock );
+
+    return result;
+}
+
+void oscc_context_unregister( oscc_context_t * const context )
+{
+    pthread_mutex_lock( &global_contexts_lock );
+
+    uint i;
+
+    for ( i = 0; i < OSCC_CONTEXT_COUNT_MAX; i++ )
+    {
+        if ( atomic_load( &global_contexts[i] ) == context )
+        {
+            atomic_store( &global_contexts[i], NULL );
+        }
+    }
+
+    pthread_mutex_unlock( &global_contexts_lock );
+
+    // A handler running on another thread may still hold the context
+    (void) oscc_wait_for_signal_handlers( );
+}
+
+oscc_result_t oscc_wait_for_signal_handlers( void )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    const struct timespec poll_interval =
+    {
+        .tv_sec = 0,
+        .tv_nsec = SIGNAL_HANDLER_POLL_NS
+    };
+
+    uint64_t waited_ns = 0;
+
+    // Sleeping rather than yielding lets a handler preempted on this CPU
+    // finish, and the bound keeps a handler stuck in a callback from hanging
+    // the caller
+    while ( (atomic_load( &global_signal_handlers_active ) > global_signal_handler_depth)
+        && (waited_ns < SIGNAL_HANDLER_WAIT_NS) )
+    {
+        nanosleep( &poll_interval, NULL );
+
+        waited_ns += SIGNAL_HANDLER_POLL_NS;
+    }
+
+    if ( atomic_load( &global_signal_handlers_active ) > global_signal_handler_depth )
+    {
+        printf( "Error: SIGIO handler did not return\n" );
+    }
+    else
+    {
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+bool oscc_channel_claimed(
+    const oscc_context_t * const context,
+    const char * can_channel )
+{
+    bool claimed = false;
+
+    pthread_mutex_lock( &global_contexts_lock );
+
+    uint i;
+
+    for ( i = 0; (claimed == false) && (i < OSCC_CONTEXT_COUNT_MAX); i++ )
+    {
+        const oscc_context_t * const other = atomic_load( &global_contexts[i] );
+
+        if ( (other == NULL) || (other == context) )
+        {
+            continue;
+        }
+
+        claimed = ( (other->oscc_can_socket >= 0)
+                && (strncmp( other->oscc_can_channel, can_channel, IFNAMSIZ ) == 0) )
+            || ( (other->vehicle_can_socket >= 0)
+                && (strncmp( other->vehicle_can_channel, can_channel, IFNAMSIZ ) == 0) );
+    }
+
+    pthread_mutex_unlock( &global_contexts_lock );
+
+    return claimed;
+}
+
+oscc_result_t oscc_start_receiving( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    oscc_map_obd_frames( context );
+
+    if ( context->receive_mode == OSCC_RECEIVE_MODE_SIGNAL )
+    {
+        result = register_can_signal( );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        result = oscc_async_enable( context, context->oscc_can_socket );
+    }
+
+    if ( result == OSCC_OK && context->vehicle_can_socket >= 0 )
+    {
+        oscc_async_enable( context, context->vehicle_can_socket );
+    }
+
+    if ( result == OSCC_OK && context->receive_mode == OSCC_RECEIVE_MODE_THREAD )
+    {
+        result = oscc_receive_thread_start( context );
+    }
+    else if ( result == OSCC_OK && context->receive_mode == OSCC_RECEIVE_MODE_BUSY_POLL )
+    {
+        result = oscc_busy_poll_thread_start( context );
+    }
+
+    // Scheduled commands need the socket, so they start along with receiving
+    if ( result == OSCC_OK )
+    {
+        result = oscc_transmit_thread_start( context );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        result = oscc_report_watchdog_start( context );
+    }
+
+    // The first load window starts with the bus open
+    (void) oscc_sample_interface_load( context, OSCC_CAN_BUS_OSCC, NULL );
+    (void) oscc_sample_interface_load( context, OSCC_CAN_BUS_VEHICLE, NULL );
+
+    return result;
+}
+
+void oscc_map_obd_frames( oscc_context_t * const context )
+{
+    const obd_vehicle_s * const obd_vehicle = context->obd_vehicle;
+
+    size_t i;
+
+    for ( i = 0; i < CAN_DISPATCH_TABLE_SIZE; i++ )
+    {
+        context->dispatch_table[i].obd_frame = NULL;
+    }
+
+    for ( i = 0; i < obd_vehicle->frame_count; i++ )
+    {
+        const obd_frame_s * const obd_frame = &obd_vehicle->frames[i];
+
+        context->dispatch_table[obd_frame->can_id & CAN_SFF_MASK].obd_frame = obd_frame;
+    }
+}
+
+const oscc_context_t * oscc_decoding_context( void )
+{
+    return ( global_current_context != NULL )
+        ? global_current_context
+        : oscc_default_context( );
+}
+
+snapshot_store_s * oscc_snapshot_store( oscc_context_t * const context )
+{
+    if ( context->snapshots_mapping != NULL )
+    {
+        return context->snapshots_mapping;
+    }
+
+    return &context->snapshots;
+}
+
+bool oscc_snapshots_tracked( const oscc_context_t * const context )
+{
+    return atomic_load_explicit( &context->snapshots_enabled, memory_order_relaxed )
+        && context->snapshots_writable;
+}
+
+void oscc_release_snapshots( oscc_context_t * const context )
+{
+    if ( context->snapshots_mapping != NULL )
+    {
+        munmap( context->snapshots_mapping, sizeof(*context->snapshots_mapping) );
+
+        context->snapshots_mapping = NULL;
+
+        if ( context->snapshots_name[0] != '\0' )
+        {
+            shm_unlink( context->snapshots_name );
+
+            context->snapshots_name[0] = '\0';
+        }
+    }
+
+    context->snapshots_writable = true;
+}
+
+unsigned int oscc_drain_socket(
+    oscc_context_t * const context,
+    int socket,
+    oscc_can_bus_t bus,
+    frame_handler_t frame_handler,
+    unsigned int max_frames )
+{
+    receive_batch_s * const batch = &context->receive_batch;
+
+    receive_buffers_s buffers;
+
+    unsigned int total = 0;
+    unsigned int batch_size = 0;
+    int received = 0;
+
+    do
+    {
+        batch_size = batch->size;
+
+        if ( (max_frames - total) < batch_size )
+        {
+            batch_size = max_frames - total;
+        }
+
+        if ( batch_size == 0 )
+        {
+            break;
+        }
+
+        unsigned int i;
+
+        for ( i = 0; i < batch_size; i++ )
+        {
+            buffers.iovecs[i].iov_base = &buffers.frames[i].frame;
+            buffers.iovecs[i].iov_len = sizeof(buffers.frames[i].frame);
+
+            memset( &buffers.headers[i], 0, sizeof(buffers.headers[i]) );
+            buffers.headers[i].msg_hdr.msg_iov = &buffers.iovecs[i];
+            buffers.headers[i].msg_hdr.msg_iovlen = 1;
+            buffers.headers[i].msg_hdr.msg_control = buffers.control[i];
+            buffers.headers[i].msg_hdr.msg_controllen = sizeof(buffers.control[i]);
+        }
+
+        received = recvmmsg( socket, buffers.headers, batch_size, MSG_DONTWAIT, NULL );
+
+        atomic_fetch_add_explicit( &batch->syscalls, 1, memory_order_relaxed );
+
+        if ( received > 0 )
+        {
+            atomic_fetch_add_explicit( &batch->frames_received, received, memory_order_relaxed );
+
+            // Only used for frames the kernel didn't timestamp
+            struct timespec now;
+            clock_gettime( CLOCK_REALTIME, &now );
+
+            int j;
+
+            for ( j = 0; j < received; j++ )
+            {
+                oscc_accept_frame( context, &buffers.headers[j].msg_hdr, bus, &now, &buffers.frames[j] );
+            }
+
+            oscc_deliver_frames( context, buffers.frames, received, frame_handler );
+
+            total += received;
+        }
+
+        // A short batch means the socket has been drained, so there is no need
+        // to spend another call discovering it is empty
+    } while ( received == (int) batch_size );
+
+    return total;
+}
+
+void oscc_accept_frame(
+    oscc_context_t * const context,
+    struct msghdr * const message,
+    oscc_can_bus_t bus,
+    const struct timespec * const now,
+    oscc_rx_frame_s * const rx_frame )
+{
+    rx_frame->bus = bus;
+
+    if ( oscc_read_timestamp( message, &rx_frame->timestamp ) == false )
+    {
+        rx_frame->timestamp = *now;
+    }
+
+    uint32_t overflows;
+
+    if ( oscc_read_overflows( message, &overflows ) == true )
+    {
+        atomic_store_explicit(
+            &context->bus_counters[bus].overflows,
+            overflows,
+            memory_order_relaxed );
+    }
+
+    oscc_count_frame( context, rx_frame );
+}
+
+void oscc_deliver_frames(
+    oscc_context_t * const context,
+    oscc_rx_frame_s * const rx_frames,
+    unsigned int count,
+    frame_handler_t frame_handler )
+{
+    // Recorded before the callbacks get a chance to modify them
+    oscc_record_frames( context, rx_frames, count );
+
+    unsigned int i;
+
+    for ( i = 0; i < count; i++ )
+    {
+        frame_handler( context, &rx_frames[i] );
+    }
+}
+
+void oscc_dispatch_frame(
+    oscc_context_t * const context,
+    oscc_rx_frame_s * const rx_frame )
+{
+    struct can_frame * const frame = &rx_frame->frame;
+    const struct timespec * const timestamp = &rx_frame->timestamp;
+
+    // Extended frames have no slot and only reach the OBD callbacks
+    const dispatch_entry_s * const entry =
+        ( (frame->can_id & CAN_EFF_FLAG) == 0 )
+            ? &context->dispatch_table[frame->can_id & CAN_SFF_MASK]
+            : NULL;
+
+    // Restored afterwards in case a signal interrupted another dispatch
+    oscc_context_t * const interrupted_context = global_current_context;
+
+    bool delivered = false;
+
+    STATS_START( dispatch_start );
+
+#ifdef OSCC_STATS
+    // Replay runs with the sockets closed and its timestamps are from the log
+    if ( context->oscc_can_socket >= 0 )
+    {
+        stats_record_receive( &context->stats, timestamp );
+    }
+#endif
+
+    global_current_context = context;
+
+    if ( (rx_frame->bus == OSCC_CAN_BUS_OSCC)
+        && (frame->data[0] == OSCC_MAGIC_BYTE_0)
+        && (frame->data[1] == OSCC_MAGIC_BYTE_1) )
+    {
+        if ( (entry != NULL) && (entry->report_decoder != NULL) )
+        {
+#ifdef OSCC_STATS
+            oscc_stats_report( context, frame->can_id, timestamp );
+#endif
+
+            entry->report_decoder( context, frame, timestamp );
+            delivered = true;
+
+            oscc_report_watchdog_feed( context, frame->can_id );
+        }
+    }
+    else if ( (rx_frame->bus == OSCC_CAN_BUS_VEHICLE) || (context->vehicle_can_socket < 0) )
+    {
+        if ( (entry != NULL) && (entry->obd_frame != NULL) )
+        {
+            oscc_decode_obd_signals( context, entry->obd_frame, frame, timestamp );
+            delivered = true;
+        }
+
+        if ( (context->callbacks.obd_frame != NULL)
+            || (context->callbacks.obd_frame_timestamped != NULL) )
+        {
+            oscc_dispatch_obd_frame( context, frame, timestamp );
+            delivered = true;
+        }
+    }
+
+    if ( entry != NULL )
+    {
+        can_id_subscription_s subscription;
+
+        seqlock_read(
+            &entry->subscription_lock,
+            &subscription,
+            &entry->subscription,
+            sizeof(subscription) );
+
+        if ( subscription.handler != NULL )
+        {
+            subscription.handler( frame, timestamp, subscription.user_data );
+            delivered = true;
+        }
+    }
+
+    if ( delivered == false )
+    {
+        oscc_count_drop( context, rx_frame );
+    }
+
+    STATS_RECORD_SINCE( &context->stats, OSCC_STATS_DISPATCH, dispatch_start );
+
+    global_current_context = interrupted_context;
+}
+
+void oscc_dispatch_obd_frame(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp )
+{
+    const callbacks_s * const callbacks = &context->callbacks;
+
+    if ( callbacks->obd_frame != NULL )
+    {
+        callbacks->obd_frame( frame );
+    }
+
+    if ( callbacks->obd_frame_timestamped != NULL )
+    {
+        callbacks->obd_frame_timestamped( frame, timestamp );
+    }
+}
+
+void oscc_decode_brake_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp )
+{
+    const callbacks_s * const callbacks = &context->callbacks;
+
+    oscc_brake_report_s *brake_report =
+        ( oscc_brake_report_s* ) frame->data;
+
+    // The snapshot is updated first so callbacks reading it see this report
+    if ( oscc_snapshots_tracked( context ) == true )
+    {
+        brake_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->brake;
+
+        // Only one thread dispatches a context at a time, so the current
+        // sequence can be read without the lock
+        oscc_brake_report_snapshot_s snapshot =
+        {
+            .report = *brake_report,
+            .timestamp = *timestamp,
+            .sequence = slot->snapshot.sequence + 1
+        };
+
+        seqlock_write( &slot->lock, &slot->snapshot, &snapshot, sizeof(snapshot) );
+    }
+
+    oscc_confirm_report( context, OSCC_REPORT_STREAM_BRAKE, brake_report->enabled != 0 );
+
+    if ( callbacks->brake_report != NULL )
+    {
+        callbacks->brake_report( brake_report );
+    }
+
+    if ( callbacks->brake_report_timestamped != NULL )
+    {
+        callbacks->brake_report_timestamped( brake_report, timestamp );
+    }
+}
+
+void oscc_decode_steering_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp )
+{
+    const callbacks_s * const callbacks = &context->callbacks;
+
+    oscc_steering_report_s *steering_report =
+        ( oscc_steering_report_s* ) frame->data;
+
+    if ( oscc_snapshots_tracked( context ) == true )
+    {
+        steering_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->steering;
+
+        oscc_steering_report_snapshot_s snapshot =
+        {
+            .report = *steering_report,
+            .timestamp = *timestamp,
+            .sequence = slot->snapshot.sequence + 1
+        };
+
+        seqlock_write( &slot->lock, &slot->snapshot, &snapshot, sizeof(snapshot) );
+    }
+
+    oscc_confirm_report( context, OSCC_REPORT_STREAM_STEERING, steering_report->enabled != 0 );
+
+    if ( callbacks->steering_report != NULL )
+    {
+        callbacks->steering_report( steering_report );
+    }
+
+    if ( callbacks->steering_report_timestamped != NULL )
+    {
+        callbacks->steering_report_timestamped( steering_report, timestamp );
+    }
+}
+
+void oscc_decode_throttle_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp )
+{
+    const callbacks_s * const callbacks = &context->callbacks;
+
+    oscc_throttle_report_s *throttle_report =
+        ( oscc_throttle_report_s* ) frame->data;
+
+    if ( oscc_snapshots_tracked( context ) == true )
+    {
+        throttle_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->throttle;
+
+        oscc_throttle_report_snapshot_s snapshot =
+        {
+            .report = *throttle_report,
+            .timestamp = *timestamp,
+            .sequence = slot->snapshot.sequence + 1
+        };
+
+        seqlock_write( &slot->lock, &slot->snapshot, &snapshot, sizeof(snapshot) );
+    }
+
+    oscc_confirm_report( context, OSCC_REPORT_STREAM_THROTTLE, throttle_report->enabled != 0 );
+
+    if ( callbacks->throttle_report != NULL )
+    {
+        callbacks->throttle_report( throttle_report );
+    }
+
+    if ( callbacks->throttle_report_timestamped != NULL )
+    {
+        callbacks->throttle_report_timestamped( throttle_report, timestamp );
+    }
+}
+
+void oscc_decode_fault_report(
+    oscc_context_t * const context,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp )
+{
+    const callbacks_s * const callbacks = &context->callbacks;
+
+    oscc_fault_report_s *fault_report =
+        ( oscc_fault_report_s* ) frame->data;
+
+    if ( oscc_snapshots_tracked( context ) == true )
+    {
+        fault_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->fault;
+
+        oscc_fault_report_snapshot_s snapshot =
+        {
+            .report = *fault_report,
+            .timestamp = *timestamp,
+            .sequence = slot->snapshot.sequence + 1
+        };
+
+        seqlock_write( &slot->lock, &slot->snapshot, &snapshot, sizeof(snapshot) );
+    }
+
+    if ( callbacks->fault_report != NULL )
+    {
+        callbacks->fault_report( fault_report );
+    }
+
+    if ( callbacks->fault_report_timestamped != NULL )
+    {
+        callbacks->fault_report_timestamped( fault_report, timestamp );
+    }
+}
+
+void oscc_decode_obd_signals(
+    oscc_context_t * const context,
+    const obd_frame_s * const obd_frame,
+    struct can_frame * const frame,
+    const struct timespec * const timestamp )
+{
+    if ( oscc_snapshots_tracked( context ) == true )
+    {
+        obd_snapshot_slot_s * const slot = &oscc_snapshot_store( context )->obd;
+
+        // Each frame only carries some of the values, the rest are kept
+        oscc_obd_snapshot_s snapshot = slot->snapshot;
+
+        double values[OSCC_OBD_SIGNAL_COUNT];
+
+        size_t i;
+
+        (void) obd_frame_decode( obd_frame, frame, values );
+
+        for ( i = 0; i < obd_frame->signal_count; i++ )
+        {
+            const oscc_obd_signal_t signal = obd_frame->signals[i].signal;
+
+            char * const base = (char *) &snapshot;
+
+            memcpy( base + global_obd_snapshot_fields[signal].value,
+                    &values[signal],
+                    sizeof(double) );
+
+            memcpy( base + global_obd_snapshot_fields[signal].timestamp,
+                    timestamp,
+                    sizeof(*timestamp) );
+        }
+
+        snapshot.sequence++;
+
+        seqlock_write( &slot->lock, &slot->snapshot, &snapshot, sizeof(snapshot) );
+    }
+}
+
+oscc_result_t oscc_can_write_frames(
+    oscc_context_t * const context,
+    struct can_frame * const frames,
+    unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( context != NULL )
+    {
+        receive_engine_s * const engine = &context->receive_engine;
+
+        STATS_START( write_start );
+
+        if ( engine->io_backend == OSCC_IO_BACKEND_IO_URING )
+        {
+            pthread_mutex_lock( &engine->transmit_lock );
+
+            if ( engine->io_ring_active == true )
+            {
+                result = oscc_io_ring_send( &engine->transmit_ring, context->oscc_can_socket, frames, count );
+            }
+            else
+            {
+                result = oscc_can_send( context->oscc_can_socket, frames, count );
+            }
+
+            pthread_mutex_unlock( &engine->transmit_lock );
+        }
+        else
+        {
+            result = oscc_can_send( context->oscc_can_socket, frames, count );
+        }
+
+        STATS_RECORD_SINCE( &context->stats, OSCC_STATS_WRITE, write_start );
+    }
+
+
+    return result;
+}
+
+oscc_result_t oscc_priority_write(
+    oscc_context_t * const context,
+    struct can_frame * const frames,
+    unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( context != NULL )
+    {
+        priority_lane_s * const lane = &context->priority_lane;
+
+        struct timespec requested;
+
+        clock_gettime( CLOCK_REALTIME, &requested );
+
+        if ( lane->socket < 0 )
+        {
+            // Without a lane of their own the frames queue behind commands
+            result = oscc_can_write_frames( context, frames, count );
+        }
+        else
+        {
+            STATS_START( write_start );
+
+            result = oscc_can_send( lane->socket, frames, count );
+
+            STATS_RECORD_SINCE( &context->stats, OSCC_STATS_WRITE, write_start );
+
+            // Bookkeeping comes after the frames are on their way
+            if ( result == OSCC_OK )
+            {
+                pthread_mutex_lock( &lane->lock );
+
+                oscc_priority_lane_drain( context );
+
+                if ( lane->count == PRIORITY_LANE_REQUESTS_MAX )
+                {
+                    // The oldest request never got its echoes
+                    lane->head = ( lane->head + 1 ) % PRIORITY_LANE_REQUESTS_MAX;
+                    lane->count--;
+                }
+
+                priority_request_s * const request =
+                    &lane->requests[(lane->head + lane->count) % PRIORITY_LANE_REQUESTS_MAX];
+
+                request->requested = requested;
+                request->frames_remaining = count;
+                lane->count++;
+
+                pthread_mutex_unlock( &lane->lock );
+            }
+        }
+    }
+
+
+    return result;
+}
+
+void oscc_priority_lane_drain( oscc_context_t * const context )
+{
+    priority_lane_s * const lane = &context->priority_lane;
+
+    struct can_frame frame;
+    char control[RECEIVE_CONTROL_SIZE];
+    struct iovec iov = { .iov_base = &frame, .iov_len = sizeof(frame) };
+
+    while ( lane->socket >= 0 )
+    {
+        struct msghdr message =
+        {
+            .msg_iov = &iov,
+            .msg_iovlen = 1,
+            .msg_control = control,
+            .msg_controllen = sizeof(control)
+        };
+
+        if ( recvmsg( lane->socket, &message, MSG_DONTWAIT ) != CAN_MTU )
+        {
+            break;
+        }
+
+        struct timespec echoed;
+
+        // Only echoes of this socket's own frames belong to a request
+        if ( ((message.msg_flags & MSG_CONFIRM) == 0)
+            || (lane->count == 0)
+            || (oscc_read_timestamp( &message, &echoed ) == false) )
+        {
+            continue;
+        }
+
+        priority_request_s * const request = &lane->requests[lane->head];
+
+        request->frames_remaining--;
+
+        if ( request->frames_remaining == 0 )
+        {
+            int64_t latency_ns =
+                ( (int64_t) (echoed.tv_sec - request->requested.tv_sec) * 1000000000LL )
+                + ( echoed.tv_nsec - request->requested.tv_nsec );
+
+            lane->last_ns = ( latency_ns > 0 ) ? (uint64_t) latency_ns : 0;
+
+            if ( lane->last_ns > lane->worst_ns )
+            {
+                lane->worst_ns = lane->last_ns;
+            }
+
+            lane->measured++;
+
+            lane->head = ( lane->head + 1 ) % PRIORITY_LANE_REQUESTS_MAX;
+            lane->count--;
+        }
+    }
+}
+
+oscc_result_t oscc_can_send(
+    int socket,
+    struct can_frame * const frames,
+    unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (socket >= 0)
+        && (frames != NULL)
+        && (count > 0)
+        && (count <= CAN_WRITE_BATCH_SIZE_MAX) )
+    {
+        struct mmsghdr headers[CAN_WRITE_BATCH_SIZE_MAX];
+        struct iovec iovecs[CAN_WRITE_BATCH_SIZE_MAX];
+
+        memset( headers, 0, sizeof(headers) );
+
+        unsigned int i;
+
+        for ( i = 0; i < count; i++ )
+        {
+            iovecs[i].iov_base = &frames[i];
+            iovecs[i].iov_len = sizeof(frames[i]);
+
+            headers[i].msg_hdr.msg_iov = &iovecs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        unsigned int sent = 0;
+
+        // sendmmsg stops at the first frame the socket refuses, so retry from
+        // there to learn whether the rest can be sent or why they can't
+        while ( sent < count )
+        {
+            int ret = sendmmsg( socket, &headers[sent], count - sent, 0 );
+
+            if ( ret > 0 )
+            {
+                sent += ret;
+            }
+            else
+            {
+                perror( "Could not write to socket:" );
+
+                break;
+            }
+        }
+
+        if ( sent == count )
+        {
+            result = OSCC_OK;
+        }
+    }
+
+
+    return result;
+}
+
+void oscc_build_frame(
+    struct can_frame * const frame,
+    long id,
+    const void *msg,
+    unsigned int dlc )
+{
+    memset( frame, 0, sizeof(*frame) );
+    frame->can_id = id;
+    frame->can_dlc = dlc;
+    memcpy( frame->data, msg, dlc );
+}
+
+void oscc_build_brake_command( struct can_frame * const frame, double brake_position )
+{
+    oscc_brake_command_s brake_cmd =
+    {
+        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
+        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
+    };
+
+    brake_cmd.pedal_command = (float) brake_position;
+
+    oscc_build_frame( frame, OSCC_BRAKE_COMMAND_CAN_ID, &brake_cmd, sizeof(brake_cmd) );
+}
+
+void oscc_build_throttle_command( struct can_frame * const frame, double throttle_position )
+{
+    oscc_throttle_command_s throttle_cmd =
+    {
+        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
+        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
+    };
+
+    throttle_cmd.torque_request = (float) throttle_position;
+
+    oscc_build_frame( frame, OSCC_THROTTLE_COMMAND_CAN_ID, &throttle_cmd, sizeof(throttle_cmd) );
+}
+
+void oscc_build_steering_command( struct can_frame * const frame, double torque )
+{
+    oscc_steering_command_s steering_cmd =
+    {
+        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
+        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
+    };
+
+    steering_cmd.torque_command = (float) torque;
+
+    oscc_build_frame( frame, OSCC_STEERING_COMMAND_CAN_ID, &steering_cmd, sizeof(steering_cmd) );
+}
+
+void oscc_build_command(
+    struct can_frame * const frame,
+    transmit_slot_t slot,
+    double command )
+{
+    if ( slot == TRANSMIT_SLOT_BRAKE )
+    {
+        oscc_build_brake_command( frame, command );
+    }
+    else if ( slot == TRANSMIT_SLOT_THROTTLE )
+    {
+        oscc_build_throttle_command( frame, command );
+    }
+    else
+    {
+        oscc_build_steering_command( frame, command );
+    }
+}
+
+oscc_result_t oscc_publish_frames(
+    oscc_context_t * const context,
+    const transmit_slot_t * const slots,
+    const double * const commands,
+    unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    unsigned int i;
+
+
+    if ( context != NULL )
+    {
+#ifdef OSCC_STATS
+        oscc_stats_commands( context, slots, count );
+#endif
+
+        if ( atomic_load_explicit( &context->transmit_scheduler.running, memory_order_acquire ) == true )
+        {
+            for ( i = 0; i < count; i++ )
+            {
+                oscc_schedule_command( context, slots[i], commands[i] );
+            }
+
+            result = OSCC_OK;
+        }
+        else
+        {
+            struct can_frame frames[TRANSMIT_SLOT_COUNT];
+
+            for ( i = 0; i < count; i++ )
+            {
+                oscc_build_command( &frames[i], slots[i], commands[i] );
+            }
+
+            result = oscc_can_write_frames( context, frames, count );
+        }
+    }
+
+
+    return result;
+}
+
+
+#ifdef OSCC_STATS
+void oscc_stats_report(
+    oscc_context_t * const context,
+    canid_t can_id,
+    const struct timespec * const timestamp )
+{
+    stats_s * const stats = &context->stats;
+
+    switch ( can_id )
+    {
+        case OSCC_BRAKE_REPORT_CAN_ID:
+            stats_record_interval( stats, OSCC_STATS_BRAKE_REPORT_INTERVAL, stats_timespec_ns( timestamp ) );
+            stats_record_since_mark( stats, OSCC_STATS_BRAKE_COMMAND_TO_REPORT, stats_now_ns( ) );
+            break;
+
+        case OSCC_STEERING_REPORT_CAN_ID:
+            stats_record_interval( stats, OSCC_STATS_STEERING_REPORT_INTERVAL, stats_timespec_ns( timestamp ) );
+            stats_record_since_mark( stats, OSCC_STATS_STEERING_COMMAND_TO_REPORT, stats_now_ns( ) );
+            break;
+
+        case OSCC_THROTTLE_REPORT_CAN_ID:
+            stats_record_interval( stats, OSCC_STATS_THROTTLE_REPORT_INTERVAL, stats_timespec_ns( timestamp ) );
+            stats_record_since_mark( stats, OSCC_STATS_THROTTLE_COMMAND_TO_REPORT, stats_now_ns( ) );
+            break;
+
+        case OSCC_FAULT_REPORT_CAN_ID:
+            stats_record_interval( stats, OSCC_STATS_FAULT_REPORT_INTERVAL, stats_timespec_ns( timestamp ) );
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+void oscc_stats_commands(
+    oscc_context_t * const context,
+    const transmit_slot_t * const slots,
+    unsigned int count )
+{
+    const uint64_t now_ns = stats_now_ns( );
+
+    unsigned int i;
+
+    for ( i = 0; i < count; i++ )
+    {
+        // Transmit slots are ordered as the command-to-report histograms are
+        stats_mark(
+            &context->stats,
+            (oscc_stats_histogram_t) ( OSCC_STATS_BRAKE_COMMAND_TO_REPORT + slots[i] ),
+            now_ns );
+    }
+}
+#endif
+
+oscc_result_t register_can_signal( )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    struct sigaction sig;
+    memset( &sig, 0, sizeof(sig) );
+
+    sigemptyset( &sig.sa_mask );
+
+    sig.sa_sigaction = oscc_update_status;
+
+    sig.sa_flags = SA_SIGINFO | SA_RESTART;
+
+    if( sigaction( SIGIO, &sig, NULL ) == 0 )
+    {
+        result = OSCC_OK;
+    }
+
+    return result;
+}
+
+
+oscc_result_t oscc_enable_timestamps( int socket )
+{
+    oscc_result_t result = OSCC_WARNING;
+
+    int flags = SOF_TIMESTAMPING_RX_HARDWARE
+        | SOF_TIMESTAMPING_RAW_HARDWARE
+        | SOF_TIMESTAMPING_RX_SOFTWARE
+        | SOF_TIMESTAMPING_SOFTWARE;
+
+    if ( setsockopt( socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags) ) == 0 )
+    {
+        result = OSCC_OK;
+    }
+    else
+    {
+        int enable = 1;
+
+        if ( setsockopt( socket, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable) ) == 0 )
+        {
+            result = OSCC_OK;
+        }
+        else
+        {
+            perror( "Warning: Enabling receive timestamps failed:" );
+        }
+    }
+
+    return result;
+}
+
+
+bool oscc_read_timestamp(
+    struct msghdr * const message,
+    struct timespec * const timestamp )
+{
+    bool found = false;
+
+    struct cmsghdr *cmsg;
+
+    for ( cmsg = CMSG_FIRSTHDR( message );
+          (cmsg != NULL) && (found == false);
+          cmsg = CMSG_NXTHDR( message, cmsg ) )
+    {
+        if ( cmsg->cmsg_level != SOL_SOCKET )
+        {
+            continue;
+        }
+
+        if ( cmsg->cmsg_type == SCM_TIMESTAMPING )
+        {
+            struct timespec stamps[3];
+
+            memcpy( stamps, CMSG_DATA( cmsg ), sizeof(stamps) );
+
+            // Index 2 holds the raw hardware timestamp and index 0 the
+            // software one, unused entries are zero
+            if ( (stamps[2].tv_sec != 0) || (stamps[2].tv_nsec != 0) )
+            {
+                *timestamp = stamps[2];
+                found = true;
+            }
+            else if ( (stamps[0].tv_sec != 0) || (stamps[0].tv_nsec != 0) )
+            {
+                *timestamp = stamps[0];
+                found = true;
+            }
+        }
+        else if ( cmsg->cmsg_type == SCM_TIMESTAMPNS )
+        {
+            memcpy( timestamp, CMSG_DATA( cmsg ), sizeof(*timestamp) );
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+
+oscc_result_t oscc_enable_overflow_counter( int socket )
+{
+    oscc_result_t result = OSCC_WARNING;
+
+    int enable = 1;
+
+    if ( setsockopt( socket, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable) ) == 0 )
+    {
+        result = OSCC_OK;
+    }
+    else
+    {
+        perror( "Warning: Enabling receive overflow counter failed:" );
+    }
+
+    return result;
+}
+
+
+bool oscc_read_overflows(
+    struct msghdr * const message,
+    uint32_t * const overflows )
+{
+    bool found = false;
+
+    struct cmsghdr *cmsg;
+
+    for ( cmsg = CMSG_FIRSTHDR( message );
+          (cmsg != NULL) && (found == false);
+          cmsg = CMSG_NXTHDR( message, cmsg ) )
+    {
+        if ( (cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SO_RXQ_OVFL) )
+        {
+            memcpy( overflows, CMSG_DATA( cmsg ), sizeof(*overflows) );
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+
+void oscc_count_frame(
+    oscc_context_t * const context,
+    const oscc_rx_frame_s * const rx_frame )
+{
+    const struct can_frame * const frame = &rx_frame->frame;
+    bus_counters_s * const bus = &context->bus_counters[rx_frame->bus];
+
+    const bool extended = ( (frame->can_id & CAN_EFF_FLAG) != 0 );
+
+    can_id_counters_s * const counters =
+        extended ? &bus->extended : &bus->ids[frame->can_id & CAN_SFF_MASK];
+
+    // Remote frames carry a length but no payload
+    const unsigned int payload =
+        ( (frame->can_id & CAN_RTR_FLAG) != 0 )
+            ? 0
+            : ( (frame->can_dlc < CAN_MAX_DLEN) ? frame->can_dlc : CAN_MAX_DLEN );
+
+    const uint64_t bits = extended
+        ? CAN_FRAME_BITS( CAN_EXTENDED_HEADER_BITS, payload )
+        : CAN_FRAME_BITS( CAN_STANDARD_HEADER_BITS, payload );
+
+    const uint64_t now_ns =
+        ( (uint64_t) rx_frame->timestamp.tv_sec * UINT64_C(1000000000) )
+        + (uint64_t) rx_frame->timestamp.tv_nsec;
+
+    atomic_fetch_add_explicit( &counters->frames, 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &counters->bytes, payload, memory_order_relaxed );
+    atomic_store_explicit( &counters->last_seen_ns, now_ns, memory_order_relaxed );
+
+    atomic_fetch_add_explicit( &bus->bits, bits, memory_order_relaxed );
+    atomic_fetch_add_explicit( &bus->window_bits, bits, memory_order_relaxed );
+
+    uint_fast64_t window_start_ns = atomic_load_explicit( &bus->window_start_ns, memory_order_relaxed );
+
+    if ( (window_start_ns == 0) || (now_ns < window_start_ns) )
+    {
+        // First frame, or the timestamps jumped back; start over
+        if ( atomic_compare_exchange_strong( &bus->window_start_ns, &window_start_ns, now_ns ) )
+        {
+            atomic_store_explicit( &bus->window_bits, 0, memory_order_relaxed );
+        }
+    }
+    else if ( ((now_ns - window_start_ns) >= BUS_LOAD_WINDOW_NS)
+        && atomic_compare_exchange_strong( &bus->window_start_ns, &window_start_ns, now_ns ) )
+    {
+        // A quiet bus stretches the window, which the load accounts for
+        const uint64_t window_bits = atomic_exchange( &bus->window_bits, 0 );
+        const double bits_per_second =
+            ( (double) window_bits * 1e9 ) / (double) ( now_ns - window_start_ns );
+
+        atomic_store_explicit(
+            &bus->load_ppm,
+            (uint64_t) ( (bits_per_second * 1e6) / OSCC_CAN_BITRATE ),
+            memory_order_relaxed );
+    }
+}
+
+
+void oscc_count_drop(
+    oscc_context_t * const context,
+    const oscc_rx_frame_s * const rx_frame )
+{
+    bus_counters_s * const bus = &context->bus_counters[rx_frame->bus];
+
+    can_id_counters_s * const counters =
+        ( (rx_frame->frame.can_id & CAN_EFF_FLAG) != 0 )
+            ? &bus->extended
+            : &bus->ids[rx_frame->frame.can_id & CAN_SFF_MASK];
+
+    atomic_fetch_add_explicit( &counters->drops, 1, memory_order_relaxed );
+}
+
+bool oscc_read_interface_counters(
+    const char * channel,
+    uint64_t * const frames,
+    uint64_t * const bytes )
+{
+    bool found = false;
+
+    const unsigned int index = if_nametoindex( channel );
+
+    int sock = ( index != 0 )
+        ? socket( AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE )
+        : UNINITIALIZED_SOCKET;
+
+    if ( sock >= 0 )
+    {
+        struct
+        {
+            struct nlmsghdr header;
+            struct ifinfomsg info;
+        } request;
+
+        memset( &request, 0, sizeof(request) );
+        request.header.nlmsg_len = NLMSG_LENGTH( sizeof(request.info) );
+        request.header.nlmsg_type = RTM_GETLINK;
+        request.header.nlmsg_flags = NLM_F_REQUEST;
+        request.header.nlmsg_seq = 1;
+        request.info.ifi_family = AF_UNSPEC;
+        request.info.ifi_index = (int) index;
+
+        char buffer[NETLINK_BUFFER_SIZE] __attribute__(( aligned( NLMSG_ALIGNTO ) ));
+
+        const ssize_t length = ( send( sock, &request, request.header.nlmsg_len, 0 ) >= 0 )
+            ? recv( sock, buffer, sizeof(buffer), 0 )
+            : -1;
+
+        struct nlmsghdr * const message = (struct nlmsghdr *) buffer;
+
+        if ( (length > 0)
+            && NLMSG_OK( message, (size_t) length )
+            && (message->nlmsg_type == RTM_NEWLINK) )
+        {
+            struct ifinfomsg * const info = NLMSG_DATA( message );
+
+            struct rtattr *attribute;
+            int attributes_length = IFLA_PAYLOAD( message );
+
+            for ( attribute = IFLA_RTA( info );
+                  (found == false) && RTA_OK( attribute, attributes_length );
+                  attribute = RTA_NEXT( attribute, attributes_length ) )
+            {
+                if ( (attribute->rta_type == IFLA_STATS64)
+                    && (RTA_PAYLOAD( attribute ) >= sizeof(struct rtnl_link_stats64)) )
+                {
+                    struct rtnl_link_stats64 stats;
+
+                    // The attribute is only aligned to four bytes
+                    memcpy( &stats, RTA_DATA( attribute ), sizeof(stats) );
+
+                    // Frames this node sends take up the bus as well
+                    *frames = stats.rx_packets + stats.tx_packets;
+                    *bytes = stats.rx_bytes + stats.tx_bytes;
+
+                    found = true;
+                }
+            }
+        }
+
+        close( sock );
+    }
+
+    return found;
+}
+
+bool oscc_sample_interface_load(
+    oscc_context_t * const context,
+    oscc_can_bus_t bus,
+    uint64_t * const load_ppm )
+{
+    bus_counters_s * const counters = &context->bus_counters[bus];
+
+    const char * const channel = ( bus == OSCC_CAN_BUS_OSCC )
+        ? context->oscc_can_channel
+        : context->vehicle_can_channel;
+
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+
+    const bool sampled = ( channel[0] != '\0' )
+        && oscc_read_interface_counters( channel, &frames, &bytes );
+
+    if ( sampled == true )
+    {
+        struct timespec now;
+
+        clock_gettime( CLOCK_MONOTONIC, &now );
+
+        const uint64_t now_ns = ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec;
+
+        pthread_mutex_lock( &context->bus_stats_lock );
+
+        if ( (counters->interface_sample_ns == 0) || (frames < counters->interface_frames) )
+        {
+            // First sample, or the interface's counters were reset; start over
+            counters->interface_sample_ns = now_ns;
+            counters->interface_frames = frames;
+            counters->interface_bytes = bytes;
+            counters->interface_load_ppm = 0;
+        }
+        else if ( (now_ns - counters->interface_sample_ns) >= BUS_LOAD_WINDOW_NS )
+        {
+            const uint64_t window_frames = frames - counters->interface_frames;
+            const uint64_t window_bytes = bytes - counters->interface_bytes;
+
+            // The counters don't tell standard frames from extended ones, so
+            // every frame is taken to be standard, with worst-case stuffing
+            const uint64_t stuffable_bits =
+                ( window_frames * CAN_STANDARD_HEADER_BITS ) + ( 8 * window_bytes );
+
+            const uint64_t window_bits = stuffable_bits
+                + ( 13 * window_frames )
+                + ( (stuffable_bits - window_frames) / 4 );
+
+            const double bits_per_second =
+                ( (double) window_bits * 1e9 ) / (double) ( now_ns - counters->interface_sample_ns );
+
+            counters->interface_sample_ns = now_ns;
+            counters->interface_frames = frames;
+            counters->interface_bytes = bytes;
+            counters->interface_load_ppm = (uint64_t) ( (bits_per_second * 1e6) / OSCC_CAN_BITRATE );
+        }
+
+        if ( load_ppm != NULL )
+        {
+            *load_ppm = counters->interface_load_ppm;
+        }
+
+        pthread_mutex_unlock( &context->bus_stats_lock );
+    }
+
+    return sampled;
+}
+
+void oscc_record_frames(
+    oscc_context_t * const context,
+    const oscc_rx_frame_s * const rx_frames,
+    unsigned int count )
+{
+    frame_recorder_s * const recorder = &context->recorder;
+
+    // Costs a single load while nothing is being recorded
+    if ( atomic_load_explicit( &recorder->fd, memory_order_relaxed ) >= 0 )
+    {
+        atomic_fetch_add( &recorder->writers, 1 );
+
+        const int fd = atomic_load( &recorder->fd );
+
+        if ( fd >= 0 )
+        {
+            frame_log_record_s records[OSCC_RECEIVE_BATCH_SIZE_MAX];
+
+            unsigned int i;
+
+            for ( i = 0; (i < count) && (i < OSCC_RECEIVE_BATCH_SIZE_MAX); i++ )
+            {
+                records[i].timestamp_ns =
+                    ( (uint64_t) rx_frames[i].timestamp.tv_sec * UINT64_C(1000000000) )
+                    + (uint64_t) rx_frames[i].timestamp.tv_nsec;
+                records[i].bus = rx_frames[i].bus;
+                records[i].reserved = 0;
+                records[i].frame = rx_frames[i].frame;
+            }
+
+            // One append per batch keeps records whole even when several
+            // threads record at once
+            const ssize_t written = write( fd, records, i * sizeof(records[0]) );
+
+            // A full disk loses frames rather than stalling the sockets
+            (void) written;
+        }
+
+        atomic_fetch_sub( &recorder->writers, 1 );
+    }
+}
+
+
+oscc_result_t oscc_frame_log_prepare( int fd )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    struct stat file_stat;
+
+    if ( fstat( fd, &file_stat ) == 0 )
+    {
+        frame_log_header_s header;
+
+        if ( file_stat.st_size == 0 )
+        {
+            header.magic = FRAME_LOG_MAGIC;
+            header.version = FRAME_LOG_VERSION;
+            header.record_size = sizeof(frame_log_record_s);
+
+            if ( write( fd, &header, sizeof(header) ) == (ssize_t) sizeof(header) )
+            {
+                result = OSCC_OK;
+            }
+        }
+        else if ( (pread( fd, &header, sizeof(header), 0 ) == (ssize_t) sizeof(header))
+            && (header.magic == FRAME_LOG_MAGIC)
+            && (header.version == FRAME_LOG_VERSION)
+            && (header.record_size == sizeof(frame_log_record_s)) )
+        {
+            const off_t partial =
+                ( file_stat.st_size - (off_t) sizeof(header) ) % (off_t) sizeof(frame_log_record_s);
+
+            if ( (partial == 0) || (ftruncate( fd, file_stat.st_size - partial ) == 0) )
+            {
+                result = OSCC_OK;
+            }
+        }
+    }
+
+    return result;
+}
+
+oscc_result_t oscc_update_can_filters( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    // Subscriptions and snapshot tracking may change from different threads,
+    // the last filter set installed must reflect all of them
+    pthread_mutex_lock( &context->filter_lock );
+
+
+    // Without a vehicle CAN socket, OBD frames forwarded by the gateway arrive
+    // on the OSCC CAN socket alongside the reports
+    if ( context->oscc_can_socket >= 0 )
+    {
+        result = oscc_apply_can_filters(
+            context,
+            context->oscc_can_socket,
+            true,
+            context->vehicle_can_socket < 0 );
+    }
+
+    if ( result == OSCC_OK && context->vehicle_can_socket >= 0 )
+    {
+        result = oscc_apply_can_filters( context, context->vehicle_can_socket, false, true );
+    }
+
+
+    pthread_mutex_unlock( &context->filter_lock );
+
+    return result;
+}
+
+
+bool oscc_add_can_filter(
+    struct can_filter * const filters,
+    unsigned int * const count,
+    canid_t can_id )
+{
+    bool added = false;
+
+    if ( *count < CAN_FILTER_COUNT_MAX )
+    {
+        filters[*count].can_id = can_id;
+        filters[*count].can_mask = CAN_FILTER_EXACT_MASK;
+        (*count)++;
+
+        added = true;
+    }
+
+    return added;
+}
+
+
+oscc_result_t oscc_apply_can_filters(
+    oscc_context_t * const context,
+    int socket,
+    bool include_reports,
+    bool include_obd )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    const callbacks_s * const callbacks = &context->callbacks;
+    const obd_filter_s * const obd_filter = &context->obd_filter;
+
+    // Snapshots need every report and the OBD frames they decode
+    const bool snapshots = atomic_load( &context->snapshots_enabled );
+
+    // The watchdog and a confirmed enable or disable read the brake, steering
+    // and throttle reports whether or not anything subscribes to them
+    const bool watched = ( context->report_watchdog.period_multiple > 0.0 )
+        || atomic_load( &context->enable_confirmation.waiting );
+
+    const bool obd_subscribed =
+        (callbacks->obd_frame != NULL) || (callbacks->obd_frame_timestamped != NULL);
+
+    struct can_filter filters[CAN_FILTER_COUNT_MAX];
+    unsigned int count = 0;
+
+    // Subscribing to every OBD message, or to more IDs than the kernel can
+    // filter, needs every frame
+    bool accept_all = (include_obd == true)
+        && (obd_subscribed == true)
+        && (obd_filter->enabled == false);
+
+    uint i;
+
+    if ( include_reports == true )
+    {
+        const struct
+        {
+            canid_t can_id;
+            bool subscribed;
+        } reports[CAN_FILTER_REPORT_COUNT] =
+        {
+            {
+                OSCC_BRAKE_REPORT_CAN_ID,
+                snapshots
+                    || watched
+                    || (callbacks->brake_report != NULL)
+                    || (callbacks->brake_report_timestamped != NULL)
+            },
+            {
+                OSCC_STEERING_REPORT_CAN_ID,
+                snapshots
+                    || watched
+                    || (callbacks->steering_report != NULL)
+                    || (callbacks->steering_report_timestamped != NULL)
+            },
+            {
+                OSCC_THROTTLE_REPORT_CAN_ID,
+                snapshots
+                    || watched
+                    || (callbacks->throttle_report != NULL)
+                    || (callbacks->throttle_report_timestamped != NULL)
+            },
+            {
+                OSCC_FAULT_REPORT_CAN_ID,
+                snapshots
+                    || (callbacks->fault_report != NULL)
+                    || (callbacks->fault_report_timestamped != NULL)
+            }
+        };
+
+        for ( i = 0; i < CAN_FILTER_REPORT_COUNT; i++ )
+        {
+            if ( reports[i].subscribed == true )
+            {
+                accept_all |= !oscc_add_can_filter( filters, &count, reports[i].can_id );
+            }
+        }
+    }
+
+    if ( include_obd == true )
+    {
+        if ( obd_subscribed == true )
+        {
+            for ( i = 0; i < obd_filter->size; i++ )
+            {
+                accept_all |= !oscc_add_can_filter( filters, &count, obd_filter->ids[i] );
+            }
+        }
+
+        for ( i = 0; (snapshots == true) && (i < context->obd_vehicle->frame_count); i++ )
+        {
+            accept_all |= !oscc_add_can_filter(
+                filters,
+                &count,
+                context->obd_vehicle->frames[i].can_id );
+        }
+    }
+
+    // Per-ID handlers take their frames from whichever bus carries them
+    for ( i = 0; (accept_all == false) && (i < CAN_DISPATCH_TABLE_SIZE); i++ )
+    {
+        if ( context->dispatch_table[i].subscription.handler != NULL )
+        {
+            accept_all |= !oscc_add_can_filter( filters, &count, i );
+        }
+    }
+
+    if ( accept_all == true )
+    {
+        // A zero mask matches every frame
+        filters[0].can_id = 0;
+        filters[0].can_mask = 0;
+        count = 1;
+    }
+
+    // An empty filter list stops the socket from receiving anything
+    int ret = setsockopt(
+        socket,
+        SOL_CAN_RAW,
+        CAN_RAW_FILTER,
+        (count > 0) ? filters : NULL,
+        count * sizeof(filters[0]) );
+
+    if ( ret < 0 )
+    {
+        perror( "Setting CAN filters failed:" );
+    }
+    else
+    {
+        result = OSCC_OK;
+    }
+
+
+    return result;
+}
+
+
+oscc_result_t oscc_async_enable( oscc_context_t * const context, int socket )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    // The receive thread or the caller's event loop waits on the sockets, they
+    // only need to stop blocking once they are drained
+    if ( context->receive_mode != OSCC_RECEIVE_MODE_SIGNAL )
+    {
+        int ret = fcntl( socket, F_SETFL, O_NONBLOCK );
+
+        if ( ret < 0 )
+        {
+            perror( "Setting nonblocking socket I/O failed:" );
+        }
+        else
+        {
+            result = OSCC_OK;
+        }
+
+        return result;
+    }
+
+    int ret = fcntl( socket, F_SETOWN, getpid( ) );
+
+    if ( ret < 0 )
+    {
+        perror( "Setting owner process of socket failed:" );
+    }
+    else
+    {
+        result = OSCC_OK;
+    }
+
+
+    if ( result == OSCC_OK )
+    {
+        ret = fcntl( socket, F_SETFL, FASYNC | O_NONBLOCK );
+
+        if ( ret < 0 )
+        {
+            perror( "Setting nonblocking asynchronous socket I/O failed:" );
+
+            result = OSCC_ERROR;
+        }
+    }
+
+
+    return result;
+}
+
+
+oscc_result_t oscc_receive_thread_start( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    receive_engine_s * const engine = &context->receive_engine;
+
+    if ( engine->started == true )
+    {
+        result = OSCC_ERROR;
+    }
+
+    if ( result == OSCC_OK )
+    {
+        frame_queue_reset( &engine->queue );
+
+        engine->stop_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+        engine->dispatch_fd = eventfd( 0, EFD_CLOEXEC );
+
+        if ( (engine->stop_fd < 0) || (engine->dispatch_fd < 0) )
+        {
+            perror( "Creating receive thread descriptors failed:" );
+
+            result = OSCC_ERROR;
+        }
+    }
+
+    // Kernels that can't run the io_uring backend get the epoll one
+    if ( (result == OSCC_OK)
+        && (engine->io_backend == OSCC_IO_BACKEND_IO_URING)
+        && (oscc_io_ring_start( context ) == OSCC_OK) )
+    {
+        pthread_mutex_lock( &engine->transmit_lock );
+
+        engine->io_ring_active = true;
+
+        pthread_mutex_unlock( &engine->transmit_lock );
+    }
+
+    if ( (result == OSCC_OK) && (engine->io_ring_active == false) )
+    {
+        engine->epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+
+        if ( engine->epoll_fd < 0 )
+        {
+            perror( "Creating receive thread descriptors failed:" );
+
+            result = OSCC_ERROR;
+        }
+    }
+
+    int sockets[] = { engine->stop_fd, context->oscc_can_socket, context->vehicle_can_socket };
+
+    uint i;
+
+    for ( i = 0;
+          (result == OSCC_OK) && (engine->io_ring_active == false) && (i < RECEIVE_EPOLL_MAX_EVENTS);
+          i++ )
+    {
+        if ( sockets[i] >= 0 )
+        {
+            struct epoll_event event =
+            {
+                .events = EPOLLIN,
+                .data.fd = sockets[i]
+            };
+
+            if ( epoll_ctl( engine->epoll_fd, EPOLL_CTL_ADD, sockets[i], &event ) < 0 )
+            {
+                perror( "Adding socket to receive thread failed:" );
+
+                result = OSCC_ERROR;
+            }
+        }
+    }
+
+    pthread_attr_t attributes;
+
+    bool attributes_initialized = false;
+
+    if ( result == OSCC_OK )
+    {
+        if ( pthread_attr_init( &attributes ) != 0 )
+        {
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            attributes_initialized = true;
+
+            result = oscc_receive_thread_attributes( engine, &attributes );
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        atomic_store( &engine->running, true );
+
+        if ( pthread_create( &engine->dispatch_thread, &attributes, oscc_dispatch_thread, context ) != 0 )
+        {
+            printf( "Error: Could not create dispatch thread\n" );
+
+            result = OSCC_ERROR;
+        }
+        else if ( pthread_create(
+                      &engine->receive_thread,
+                      &attributes,
+                      ( engine->io_ring_active == true ) ? oscc_io_ring_receive_thread : oscc_receive_thread,
+                      context ) != 0 )
+        {
+            printf( "Error: Could not create receive thread\n" );
+
+            atomic_store( &engine->running, false );
+            eventfd_write( engine->dispatch_fd, 1 );
+            pthread_join( engine->dispatch_thread, NULL );
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            engine->started = true;
+        }
+    }
+
+    if ( attributes_initialized == true )
+    {
+        pthread_attr_destroy( &attributes );
+    }
+
+    if ( result != OSCC_OK && engine->started == false )
+    {
+        if ( engine->io_ring_active == true )
+        {
+            oscc_io_ring_stop( context );
+        }
+
+        int * descriptors[] = { &engine->epoll_fd, &engine->stop_fd, &engine->dispatch_fd };
+
+        for ( i = 0; i < (sizeof(descriptors) / sizeof(descriptors[0])); i++ )
+        {
+            if ( *descriptors[i] >= 0 )
+            {
+                close( *descriptors[i] );
+
+                *descriptors[i] = UNINITIALIZED_SOCKET;
+            }
+        }
+    }
+
+    return result;
+}
+
+
+oscc_result_t oscc_receive_thread_stop( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    receive_engine_s * const engine = &context->receive_engine;
+
+    if ( (engine->started == true) && (context->receive_mode == OSCC_RECEIVE_MODE_BUSY_POLL) )
+    {
+        // The polling thread never blocks for long, so it sees running
+        // cleared without being woken
+        atomic_store( &engine->running, false );
+
+        pthread_join( engine->receive_thread, NULL );
+
+        engine->started = false;
+    }
+    else if ( engine->started == true )
+    {
+        atomic_store( &engine->running, false );
+
+        if ( (eventfd_write( engine->stop_fd, 1 ) < 0)
+            || (eventfd_write( engine->dispatch_fd, 1 ) < 0) )
+        {
+            perror( "Waking receive threads failed:" );
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            pthread_join( engine->receive_thread, NULL );
+            pthread_join( engine->dispatch_thread, NULL );
+
+            if ( engine->io_ring_active == true )
+            {
+                oscc_io_ring_stop( context );
+            }
+            else
+            {
+                close( engine->epoll_fd );
+            }
+
+            close( engine->stop_fd );
+            close( engine->dispatch_fd );
+
+            engine->epoll_fd = UNINITIALIZED_SOCKET;
+            engine->stop_fd = UNINITIALIZED_SOCKET;
+            engine->dispatch_fd = UNINITIALIZED_SOCKET;
+            engine->started = false;
+        }
+    }
+
+    return result;
+}
+
+
+oscc_result_t oscc_busy_poll_thread_start( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    receive_engine_s * const engine = &context->receive_engine;
+
+    const int busy_poll_us = (int) engine->busy_poll.socket_busy_poll_us;
+
+    if ( engine->started == true )
+    {
+        result = OSCC_ERROR;
+    }
+
+    if ( (result == OSCC_OK) && (busy_poll_us > 0) )
+    {
+        int sockets[] = { context->oscc_can_socket, context->vehicle_can_socket };
+
+        unsigned int i;
+
+        for ( i = 0; (result == OSCC_OK) && (i < (sizeof(sockets) / sizeof(sockets[0]))); i++ )
+        {
+            if ( (sockets[i] >= 0)
+                && (setsockopt( sockets[i], SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us) ) < 0) )
+            {
+                perror( "Setting socket busy poll failed:" );
+
+                result = OSCC_ERROR;
+            }
+        }
+    }
+
+    pthread_attr_t attributes;
+
+    bool attributes_initialized = false;
+
+    if ( result == OSCC_OK )
+    {
+        if ( pthread_attr_init( &attributes ) != 0 )
+        {
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            attributes_initialized = true;
+
+            result = oscc_receive_thread_attributes( engine, &attributes );
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        atomic_store( &engine->running, true );
+
+        if ( pthread_create( &engine->receive_thread, &attributes, oscc_busy_poll_thread, context ) != 0 )
+        {
+            printf( "Error: Could not create busy poll thread\n" );
+
+            atomic_store( &engine->running, false );
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            engine->dispatch_thread = engine->receive_thread;
+            engine->started = true;
+        }
+    }
+
+    if ( attributes_initialized == true )
+    {
+        pthread_attr_destroy( &attributes );
+    }
+
+    return result;
+}
+
+
+oscc_result_t oscc_receive_thread_attributes(
+    const receive_engine_s * const engine,
+    pthread_attr_t * const attributes )
+{
+    oscc_result_t result = OSCC_OK;
+
+    // Every page the threads touch, including the frame queue and receive
+    // batch inside the context and the stacks created with these attributes,
+    // is faulted in and locked here rather than on the first frame
+    if ( engine->lock_memory == true )
+    {
+        if ( mlockall( MCL_CURRENT | MCL_FUTURE ) < 0 )
+        {
+            perror( "Locking memory for receive threads failed:" );
+
+            return OSCC_ERROR;
+        }
+
+        if ( pthread_attr_setstacksize( attributes, RECEIVE_THREAD_STACK_SIZE ) != 0 )
+        {
+            result = OSCC_ERROR;
+        }
+    }
+
+    if ( (result == OSCC_OK) && (engine->priority > 0) )
+    {
+        struct sched_param parameters = { .sched_priority = engine->priority };
+
+        if ( (pthread_attr_setinheritsched( attributes, PTHREAD_EXPLICIT_SCHED ) != 0)
+            || (pthread_attr_setschedpolicy( attributes, SCHED_FIFO ) != 0)
+            || (pthread_attr_setschedparam( attributes, &parameters ) != 0) )
+        {
+            result = OSCC_ERROR;
+        }
+    }
+
+    if ( (result == OSCC_OK) && (engine->cpu >= 0) )
+    {
+        cpu_set_t cpus;
+
+        CPU_ZERO( &cpus );
+        CPU_SET( engine->cpu, &cpus );
+
+        if ( pthread_attr_setaffinity_np( attributes, sizeof(cpus), &cpus ) != 0 )
+        {
+            result = OSCC_ERROR;
+        }
+    }
+
+    if ( result != OSCC_OK )
+    {
+        printf( "Error: Could not apply real-time settings to receive threads\n" );
+    }
+
+    return result;
+}
+
+
+void * oscc_receive_thread( void * arg )
+{
+    oscc_context_t * const context = arg;
+    receive_engine_s * const engine = &context->receive_engine;
+
+    struct epoll_event events[RECEIVE_EPOLL_MAX_EVENTS];
+
+    while ( atomic_load( &engine->running ) == true )
+    {
+        int count = epoll_wait( engine->epoll_fd, events, RECEIVE_EPOLL_MAX_EVENTS, -1 );
+
+        if ( count < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+
+            perror( "Waiting on CAN sockets failed:" );
+
+            break;
+        }
+
+        bool queued = false;
+
+        int i;
+
+        for ( i = 0; i < count; i++ )
+        {
+            int socket = events[i].data.fd;
+
+            if ( socket == context->oscc_can_socket )
+            {
+                queued |= ( oscc_drain_socket( context, socket, OSCC_CAN_BUS_OSCC, oscc_queue_frame, UINT_MAX ) > 0 );
+            }
+            else if ( socket == context->vehicle_can_socket )
+            {
+                queued |= ( oscc_drain_socket( context, socket, OSCC_CAN_BUS_VEHICLE, oscc_queue_frame, UINT_MAX ) > 0 );
+            }
+        }
+
+        // One wakeup per batch rather than per frame
+        if ( queued == true )
+        {
+            eventfd_write( engine->dispatch_fd, 1 );
+        }
+    }
+
+    return NULL;
+}
+
+
+void * oscc_dispatch_thread( void * arg )
+{
+    oscc_context_t * const context = arg;
+    receive_engine_s * const engine = &context->receive_engine;
+
+    oscc_rx_frame_s rx_frame;
+
+    while ( atomic_load( &engine->running ) == true )
+    {
+        eventfd_t pending;
+
+        if ( eventfd_read( engine->dispatch_fd, &pending ) < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+
+            perror( "Waiting on receive thread failed:" );
+
+            break;
+        }
+
+        while ( (atomic_load_explicit( &engine->running, memory_order_relaxed ) == true)
+            && (frame_queue_pop( &engine->queue, &rx_frame ) == true) )
+        {
+            oscc_dispatch_frame( context, &rx_frame );
+        }
+    }
+
+    return NULL;
+}
+
+
+void * oscc_busy_poll_thread( void * arg )
+{
+    oscc_context_t * const context = arg;
+    receive_engine_s * const engine = &context->receive_engine;
+    const oscc_busy_poll_s * const busy_poll = &engine->busy_poll;
+
+    const struct timespec backoff =
+    {
+        .tv_sec = 0,
+        .tv_nsec = busy_poll->backoff_ns
+    };
+
+    unsigned int idle_polls = 0;
+
+    while ( atomic_load_explicit( &engine->running, memory_order_relaxed ) == true )
+    {
+        unsigned int received = 0;
+
+        // Reports are handled ahead of the vehicle's OBD traffic
+        if ( context->oscc_can_socket >= 0 )
+        {
+            received += oscc_drain_socket(
+                context,
+                context->oscc_can_socket,
+                OSCC_CAN_BUS_OSCC,
+                oscc_dispatch_frame,
+                UINT_MAX );
+        }
+
+        if ( context->vehicle_can_socket >= 0 )
+        {
+            received += oscc_drain_socket(
+                context,
+                context->vehicle_can_socket,
+                OSCC_CAN_BUS_VEHICLE,
+                oscc_dispatch_frame,
+                UINT_MAX );
+        }
+
+        if ( received > 0 )
+        {
+            idle_polls = 0;
+        }
+        else if ( idle_polls < busy_poll->spin_budget )
+        {
+            idle_polls++;
+        }
+        else if ( busy_poll->backoff == OSCC_BUSY_POLL_BACKOFF_YIELD )
+        {
+            sched_yield( );
+        }
+        else if ( busy_poll->backoff == OSCC_BUSY_POLL_BACKOFF_SLEEP )
+        {
+            nanosleep( &backoff, NULL );
+        }
+    }
+
+    return NULL;
+}
+
+
+#ifdef IO_RING_SUPPORTED
+
+oscc_result_t oscc_io_ring_open( io_ring_s * const ring, unsigned int flags )
+{
+    oscc_result_t result = OSCC_OK;
+
+    struct io_uring_params params;
+
+    memset( &params, 0, sizeof(params) );
+    params.flags = flags;
+
+    ring->fd = io_ring_setup( IO_RING_ENTRIES, &params );
+    ring->mapping = MAP_FAILED;
+    ring->sqes = MAP_FAILED;
+    ring->to_submit = 0;
+
+    // Kernels without a flag asked for refuse the setup, which is how the
+    // backend finds out it has to fall back
+    if ( (ring->fd < 0) || ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) )
+    {
+        result = OSCC_ERROR;
+    }
+
+    if ( result == OSCC_OK )
+    {
+        const size_t sq_size = params.sq_off.array + ( params.sq_entries * sizeof(unsigned int) );
+        const size_t cq_size = params.cq_off.cqes + ( params.cq_entries * sizeof(struct io_uring_cqe) );
+
+        ring->mapping_size = ( sq_size > cq_size ) ? sq_size : cq_size;
+        ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+        ring->mapping = mmap(
+            NULL,
+            ring->mapping_size,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            ring->fd,
+            IORING_OFF_SQ_RING );
+
+        ring->sqes = mmap(
+            NULL,
+            ring->sqes_size,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            ring->fd,
+            IORING_OFF_SQES );
+
+        if ( (ring->mapping == MAP_FAILED) || (ring->sqes == MAP_FAILED) )
+        {
+            perror( "Mapping io_uring failed:" );
+
+            result = OSCC_ERROR;
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        unsigned char * const base = ring->mapping;
+
+        ring->sq_head = (_Atomic unsigned int *) ( base + params.sq_off.head );
+        ring->sq_tail = (_Atomic unsigned int *) ( base + params.sq_off.tail );
+        ring->sq_mask = *(unsigned int *) ( base + params.sq_off.ring_mask );
+        ring->sq_array = (unsigned int *) ( base + params.sq_off.array );
+        ring->cq_head = (_Atomic unsigned int *) ( base + params.cq_off.head );
+        ring->cq_tail = (_Atomic unsigned int *) ( base + params.cq_off.tail );
+        ring->cq_mask = *(unsigned int *) ( base + params.cq_off.ring_mask );
+        ring->cqes = (struct io_uring_cqe *) ( base + params.cq_off.cqes );
+    }
+    else
+    {
+        oscc_io_ring_close( ring );
+    }
+
+    return result;
+}
+
+
+void oscc_io_ring_close( io_ring_s * const ring )
+{
+    if ( ring->sqes != MAP_FAILED )
+    {
+        munmap( ring->sqes, ring->sqes_size );
+
+        ring->sqes = MAP_FAILED;
+    }
+
+    if ( ring->mapping != MAP_FAILED )
+    {
+        munmap( ring->mapping, ring->mapping_size );
+
+        ring->mapping = MAP_FAILED;
+    }
+
+    if ( ring->fd >= 0 )
+    {
+        close( ring->fd );
+
+        ring->fd = UNINITIALIZED_SOCKET;
+    }
+}
+
+
+oscc_result_t oscc_io_ring_start( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    receive_engine_s * const engine = &context->receive_engine;
+    io_ring_receiver_s * const receiver = &engine->receiver;
+
+    receiver->buffers_size = 0;
+
+    // Only the receive thread submits to its ring, which it enables once
+    // running so the kernel can skip the locking other submitters need
+    result = oscc_io_ring_open(
+        &receiver->ring,
+        IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_R_DISABLED );
+
+    if ( result == OSCC_OK )
+    {
+        result = oscc_io_ring_open( &engine->transmit_ring, IORING_SETUP_COOP_TASKRUN );
+    }
+
+    if ( result == OSCC_OK )
+    {
+        const size_t ring_size = IO_RING_BUFFER_COUNT * sizeof(struct io_uring_buf);
+
+        receiver->buffer_size = IO_RING_BUFFER_SIZE;
+        receiver->buffers_size = ring_size + ( IO_RING_BUFFER_COUNT * receiver->buffer_size );
+
+        void * const mapping = mmap(
+            NULL,
+            receiver->buffers_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+            -1,
+            0 );
+
+        if ( mapping == MAP_FAILED )
+        {
+            perror( "Allocating io_uring buffers failed:" );
+
+            receiver->buffers_size = 0;
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            receiver->buffer_ring = mapping;
+            receiver->buffers = (unsigned char *) mapping + ring_size;
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        struct io_uring_buf_reg registration;
+
+        memset( &registration, 0, sizeof(registration) );
+        registration.ring_addr = (unsigned long) receiver->buffer_ring;
+        registration.ring_entries = IO_RING_BUFFER_COUNT;
+        registration.bgid = 0;
+
+        if ( io_ring_register( &receiver->ring, IORING_REGISTER_PBUF_RING, &registration, 1 ) < 0 )
+        {
+            result = OSCC_ERROR;
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        unsigned int i;
+
+        receiver->buffer_ring->tail = 0;
+
+        for ( i = 0; i < IO_RING_BUFFER_COUNT; i++ )
+        {
+            io_ring_buffer_return( receiver, i, i );
+        }
+
+        io_ring_buffers_publish( receiver, IO_RING_BUFFER_COUNT );
+
+        // Each buffer is laid out with room for this much control data
+        memset( &receiver->receive_message, 0, sizeof(receiver->receive_message) );
+        receiver->receive_message.msg_controllen = RECEIVE_CONTROL_SIZE;
+    }
+    else
+    {
+        oscc_io_ring_stop( context );
+    }
+
+    return result;
+}
+
+
+void oscc_io_ring_stop( oscc_context_t * const context )
+{
+    receive_engine_s * const engine = &context->receive_engine;
+    io_ring_receiver_s * const receiver = &engine->receiver;
+
+    oscc_io_ring_close( &receiver->ring );
+
+    // Commands being written finish before their ring goes away
+    pthread_mutex_lock( &engine->transmit_lock );
+
+    oscc_io_ring_close( &engine->transmit_ring );
+
+    engine->io_ring_active = false;
+
+    pthread_mutex_unlock( &engine->transmit_lock );
+
+    // The kernel drops its references to the buffers with the ring
+    if ( receiver->buffers_size > 0 )
+    {
+        munmap( receiver->buffer_ring, receiver->buffers_size );
+
+        receiver->buffers_size = 0;
+    }
+}
+
+
+oscc_result_t oscc_io_ring_arm_receive(
+    oscc_context_t * const context,
+    oscc_can_bus_t bus )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+    io_ring_receiver_s * const receiver = &context->receive_engine.receiver;
+
+    const int socket =
+        ( bus == OSCC_CAN_BUS_OSCC ) ? context->oscc_can_socket : context->vehicle_can_socket;
+
+    struct io_uring_sqe * const sqe = io_ring_get_sqe( &receiver->ring );
+
+    if ( (socket >= 0) && (sqe != NULL) )
+    {
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = socket;
+        sqe->addr = (unsigned long) &receiver->receive_message;
+        sqe->len = 1;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+        sqe->user_data = bus;
+
+        result = OSCC_OK;
+    }
+
+    return result;
+}
+
+
+oscc_result_t oscc_io_ring_send(
+    io_ring_s * const ring,
+    int socket,
+    struct can_frame * const frames,
+    unsigned int count )
+{
+    oscc_result_t result = OSCC_ERROR;
+
+
+    if ( (ring->fd >= 0)
+        && (socket >= 0)
+        && (frames != NULL)
+        && (count > 0)
+        && (count <= CAN_WRITE_BATCH_SIZE_MAX) )
+    {
+        unsigned int queued;
+
+        // Every send is waited for, so the queue is empty on entry and has
+        // room for a whole batch
+        for ( queued = 0; queued < count; queued++ )
+        {
+            struct io_uring_sqe * const sqe = io_ring_get_sqe( ring );
+
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = socket;
+            sqe->addr = (unsigned long) &frames[queued];
+            sqe->len = sizeof(frames[queued]);
+            sqe->user_data = IO_RING_TAG_SEND;
+
+            // A frame the socket refuses cancels the ones after it, so they
+            // still go out in order or not at all
+            if ( queued < (count - 1) )
+            {
+                sqe->flags = IOSQE_IO_LINK;
+            }
+        }
+
+        unsigned int completed = 0;
+
+        int error = 0;
+
+        while ( (ring->to_submit > 0) || (completed < queued) )
+        {
+            int ret = io_ring_enter( ring, ring->to_submit, queued - completed, IORING_ENTER_GETEVENTS );
+
+            if ( ret < 0 )
+            {
+                if ( errno == EINTR )
+                {
+                    continue;
+                }
+
+                // The kernel took none of the entries, which are withdrawn
+                // so a later batch does not send them
+                error = errno;
+
+                atomic_store_explicit(
+                    ring->sq_tail,
+                    atomic_load_explicit( ring->sq_head, memory_order_acquire ),
+                    memory_order_release );
+
+                ring->to_submit = 0;
+                queued = completed;
+
+                break;
+            }
+
+            ring->to_submit -= (unsigned int) ret;
+
+            struct io_uring_cqe * cqe;
+
+            while ( (cqe = io_ring_peek_cqe( ring )) != NULL )
+            {
+                if ( (cqe->res < 0) && (error == 0) )
+                {
+                    error = -cqe->res;
+                }
+
+                completed++;
+
+                io_ring_cqe_seen( ring );
+            }
+        }
+
+        if ( error == 0 )
+        {
+            result = OSCC_OK;
+        }
+        else
+        {
+            errno = error;
+
+            perror( "Could not write to socket:" );
+        }
+    }
+
+
+    return result;
+}
+
+
+void * oscc_io_ring_receive_thread( void * arg )
+{
+    oscc_context_t * const context = arg;
+    receive_engine_s * const engine = &context->receive_engine;
+    io_ring_receiver_s * const receiver = &engine->receiver;
+    io_ring_s * const ring = &receiver->ring;
+    receive_batch_s * const batch = &context->receive_batch;
+
+    oscc_rx_frame_s rx_frames[IO_RING_FRAME_BATCH];
+
+    bool armed[OSCC_CAN_BUS_COUNT] = { false };
+
+    // Makes this thread the ring's only submitter
+    if ( io_ring_register( ring, IORING_REGISTER_ENABLE_RINGS, NULL, 0 ) < 0 )
+    {
+        perror( "Enabling io_uring failed:" );
+
+        return NULL;
+    }
+
+    struct io_uring_sqe * const stop = io_ring_get_sqe( ring );
+
+    stop->opcode = IORING_OP_POLL_ADD;
+    stop->fd = engine->stop_fd;
+    stop->poll32_events = POLLIN;
+    stop->user_data = IO_RING_TAG_STOP;
+
+    while ( atomic_load( &engine->running ) == true )
+    {
+        unsigned int bus;
+
+        for ( bus = 0; bus < OSCC_CAN_BUS_COUNT; bus++ )
+        {
+            if ( (armed[bus] == false) && (oscc_io_ring_arm_receive( context, bus ) == OSCC_OK) )
+            {
+                armed[bus] = true;
+            }
+        }
+
+        // Completions already waiting are taken without entering the kernel
+        if ( (ring->to_submit > 0) || (io_ring_peek_cqe( ring ) == NULL) )
+        {
+            int ret = io_ring_enter( ring, ring->to_submit, 1, IORING_ENTER_GETEVENTS );
+
+            atomic_fetch_add_explicit( &batch->syscalls, 1, memory_order_relaxed );
+
+            if ( ret < 0 )
+            {
+                if ( errno == EINTR )
+                {
+                    continue;
+                }
+
+                perror( "Waiting on io_uring failed:" );
+
+                break;
+            }
+
+            ring->to_submit -= (unsigned int) ret;
+        }
+
+        // Only used for frames the kernel didn't timestamp
+        struct timespec now;
+        clock_gettime( CLOCK_REALTIME, &now );
+
+        unsigned int count = 0;
+        unsigned int returned = 0;
+
+        struct io_uring_cqe * cqe;
+
+        while ( (cqe = io_ring_peek_cqe( ring )) != NULL )
+        {
+            if ( cqe->user_data < OSCC_CAN_BUS_COUNT )
+            {
+                bus = (unsigned int) cqe->user_data;
+
+                if ( (cqe->flags & IORING_CQE_F_BUFFER) != 0 )
+                {
+                    const unsigned int id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+
+                    unsigned char * const buffer = receiver->buffers + ( (size_t) id * receiver->buffer_size );
+
+                    const struct io_uring_recvmsg_out * const out = (const void *) buffer;
+
+                    // Laid out as the header, the name and control space
+                    // reserved by receive_message, then the payload
+                    unsigned char * const control = buffer + sizeof(*out);
+                    unsigned char * const payload = control + RECEIVE_CONTROL_SIZE;
+
+                    if ( (cqe->res >= 0)
+                        && (out->payloadlen == sizeof(struct can_frame))
+                        && ((out->flags & MSG_TRUNC) == 0) )
+                    {
+                        struct msghdr message =
+                        {
+                            .msg_control = control,
+                            .msg_controllen = out->controllen
+                        };
+
+                        memcpy( &rx_frames[count].frame, payload, sizeof(rx_frames[count].frame) );
+
+                        oscc_accept_frame( context, &message, bus, &now, &rx_frames[count] );
+
+                        count++;
+                    }
+
+                    io_ring_buffer_return( receiver, id, returned );
+                    returned++;
+                }
+                else if ( (cqe->res < 0) && (cqe->res != -ENOBUFS) )
+                {
+                    // Left unarmed rather than failing over and over
+                    errno = -cqe->res;
+
+                    perror( "Receiving from CAN socket failed:" );
+                }
+
+                // Ends when the buffers run out, rearmed once they are back
+                if ( ((cqe->flags & IORING_CQE_F_MORE) == 0)
+                    && ((cqe->res >= 0) || (cqe->res == -ENOBUFS)) )
+                {
+                    armed[bus] = false;
+                }
+            }
+
+            io_ring_cqe_seen( ring );
+
+            if ( count == IO_RING_FRAME_BATCH )
+            {
+                break;
+            }
+        }
+
+        if ( returned > 0 )
+        {
+            io_ring_buffers_publish( receiver, returned );
+        }
+
+        if ( count > 0 )
+        {
+            atomic_fetch_add_explicit( &batch->frames_received, count, memory_order_relaxed );
+
+            oscc_deliver_frames( context, rx_frames, count, oscc_queue_frame );
+
+            // One wakeup per batch rather than per frame
+            eventfd_write( engine->dispatch_fd, 1 );
+        }
+    }
+
+    return NULL;
+}
+
+#else
+
+oscc_result_t oscc_io_ring_start( oscc_context_t * const context )
+{
+    (void) context;
+
+    return OSCC_ERROR;
+}
+
+
+void oscc_io_ring_stop( oscc_context_t * const context )
+{
+    (void) context;
+}
+
+
+oscc_result_t oscc_io_ring_send(
+    io_ring_s * const ring,
+    int socket,
+    struct can_frame * const frames,
+    unsigned int count )
+{
+    (void) ring;
+    (void) socket;
+    (void) frames;
+    (void) count;
+
+    return OSCC_ERROR;
+}
+
+
+void * oscc_io_ring_receive_thread( void * arg )
+{
+    (void) arg;
+
+    return NULL;
+}
+
+#endif /* IO_RING_SUPPORTED */
+
+
+oscc_result_t oscc_transmit_thread_start( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    transmit_scheduler_s * const scheduler = &context->transmit_scheduler;
+
+    if ( (scheduler->rate == 0) || (scheduler->started == true) )
+    {
+        return result;
+    }
+
+    unsigned int i;
+
+    for ( i = 0; i < TRANSMIT_SLOT_COUNT; i++ )
+    {
+        atomic_store( &scheduler->slots[i], 0 );
+    }
+
+    scheduler->timer_fd = timerfd_create( CLOCK_MONOTONIC, TFD_CLOEXEC );
+    scheduler->stop_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+
+    if ( (scheduler->timer_fd < 0) || (scheduler->stop_fd < 0) )
+    {
+        perror( "Creating transmit thread descriptors failed:" );
+
+        result = OSCC_ERROR;
+    }
+
+    if ( result == OSCC_OK )
+    {
+        const long period_ns = 1000000000L / scheduler->rate;
+
+        // Ticks are set against an absolute start so they do not drift
+        // however late each one is handled
+        struct itimerspec timer =
+        {
+            .it_interval = { .tv_sec = period_ns / 1000000000L, .tv_nsec = period_ns % 1000000000L }
+        };
+
+        clock_gettime( CLOCK_MONOTONIC, &timer.it_value );
+
+        timer.it_value.tv_nsec += period_ns;
+
+        if ( timer.it_value.tv_nsec >= 1000000000L )
+        {
+            timer.it_value.tv_sec++;
+            timer.it_value.tv_nsec -= 1000000000L;
+        }
+
+        if ( timerfd_settime( scheduler->timer_fd, TFD_TIMER_ABSTIME, &timer, NULL ) < 0 )
+        {
+            perror( "Starting transmit timer failed:" );
+
+            result = OSCC_ERROR;
+        }
+    }
+
+    if ( result == OSCC_OK )
+    {
+        atomic_store( &scheduler->running, true );
+
+        if ( pthread_create( &scheduler->thread, NULL, oscc_transmit_thread, context ) != 0 )
+        {
+            printf( "Error: Could not create transmit thread\n" );
+
+            atomic_store( &scheduler->running, false );
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            scheduler->started = true;
+        }
+    }
+
+    if ( result != OSCC_OK )
+    {
+        int * descriptors[] = { &scheduler->timer_fd, &scheduler->stop_fd };
+
+        for ( i = 0; i < (sizeof(descriptors) / sizeof(descriptors[0])); i++ )
+        {
+            if ( *descriptors[i] >= 0 )
+            {
+                close( *descriptors[i] );
+
+                *descriptors[i] = UNINITIALIZED_SOCKET;
+            }
+        }
+    }
+
+    return result;
+}
+
+
+oscc_result_t oscc_transmit_thread_stop( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    transmit_scheduler_s * const scheduler = &context->transmit_scheduler;
+
+    if ( scheduler->started == true )
+    {
+        // Publishers go back to writing directly from here on
+        atomic_store( &scheduler->running, false );
+
+        if ( eventfd_write( scheduler->stop_fd, 1 ) < 0 )
+        {
+            perror( "Waking transmit thread failed:" );
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            pthread_join( scheduler->thread, NULL );
+
+            close( scheduler->timer_fd );
+            close( scheduler->stop_fd );
+
+            scheduler->timer_fd = UNINITIALIZED_SOCKET;
+            scheduler->stop_fd = UNINITIALIZED_SOCKET;
+            scheduler->started = false;
+        }
+    }
+
+    return result;
+}
+
+
+void * oscc_transmit_thread( void * arg )
+{
+    oscc_context_t * const context = arg;
+    transmit_scheduler_s * const scheduler = &context->transmit_scheduler;
+
+    struct pollfd poll_fds[] =
+    {
+        { .fd = scheduler->timer_fd, .events = POLLIN },
+        { .fd = scheduler->stop_fd, .events = POLLIN }
+    };
+
+    while ( atomic_load( &scheduler->running ) == true )
+    {
+        if ( poll( poll_fds, 2, -1 ) < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+
+            perror( "Waiting on transmit timer failed:" );
+
+            break;
+        }
+
+        uint64_t expirations;
+
+        // Ticks missed while the thread was held up are not made up for, the
+        // latest commands go out once
+        if ( read( scheduler->timer_fd, &expirations, sizeof(expirations) ) == sizeof(expirations) )
+        {
+            oscc_transmit_pending( context );
+        }
+    }
+
+    return NULL;
+}
+
+
+oscc_result_t oscc_report_watchdog_start( oscc_context_t * const context )
+{
+    oscc_result_t result = OSCC_OK;
+
+    report_watchdog_s * const watchdog = &context->report_watchdog;
+
+    if ( (watchdog->period_multiple == 0.0) || (watchdog->started == true) )
+    {
+        return result;
+    }
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    const uint64_t now_ns = ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec;
+
+    unsigned int i;
+
+    // Modules that never report at all go stale one deadline after opening
+    for ( i = 0; i < OSCC_REPORT_STREAM_COUNT; i++ )
     {
-        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
-        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
-    };
+        atomic_store( &watchdog->last_report_ns[i], now_ns );
+        atomic_store( &watchdog->stale[i], false );
+    }
 
-    result = oscc_can_write(
-        OSCC_BRAKE_DISABLE_CAN_ID,
-        (void *) &brake_disable,
-        sizeof(brake_disable) );
+    watchdog->timer_fd = timerfd_create( CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK );
+    watchdog->stop_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
 
+    if ( (watchdog->timer_fd < 0) || (watchdog->stop_fd < 0) )
+    {
+        perror( "Creating report watchdog descriptors failed:" );
 
-    return result;
-}
+        result = OSCC_ERROR;
+    }
 
-oscc_result_t oscc_disable_throttle( void )
-{
-    oscc_result_t result = OSCC_ERROR;
+    if ( result == OSCC_OK )
+    {
+        atomic_store( &watchdog->running, true );
 
+        if ( pthread_create( &watchdog->thread, NULL, oscc_report_watchdog_thread, context ) != 0 )
+        {
+            printf( "Error: Could not create report watchdog thread\n" );
 
-    oscc_throttle_disable_s throttle_disable =
+            atomic_store( &watchdog->running, false );
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            watchdog->started = true;
+        }
+    }
+
+    if ( result != OSCC_OK )
     {
-        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
-        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
-    };
+        int * descriptors[] = { &watchdog->timer_fd, &watchdog->stop_fd };
 
-    result = oscc_can_write(
-        OSCC_THROTTLE_DISABLE_CAN_ID,
-        (void *) &throttle_disable,
-        sizeof(throttle_disable) );
+        for ( i = 0; i < (sizeof(descriptors) / sizeof(descriptors[0])); i++ )
+        {
+            if ( *descriptors[i] >= 0 )
+            {
+                close( *descriptors[i] );
 
+                *descriptors[i] = UNINITIALIZED_SOCKET;
+            }
+        }
+    }
 
     return result;
 }
 
-oscc_result_t oscc_disable_steering( void )
+
+oscc_result_t oscc_report_watchdog_stop( oscc_context_t * const context )
 {
-    oscc_result_t result = OSCC_ERROR;
+    oscc_result_t result = OSCC_OK;
 
+    report_watchdog_s * const watchdog = &context->report_watchdog;
 
-    oscc_steering_disable_s steering_disable =
+    if ( watchdog->started == true )
     {
-        .magic[0] = ( uint8_t ) OSCC_MAGIC_BYTE_0,
-        .magic[1] = ( uint8_t ) OSCC_MAGIC_BYTE_1
-    };
+        atomic_store( &watchdog->running, false );
+
+        if ( eventfd_write( watchdog->stop_fd, 1 ) < 0 )
+        {
+            perror( "Waking report watchdog thread failed:" );
+
+            result = OSCC_ERROR;
+        }
+        else
+        {
+            pthread_join( watchdog->thread, NULL );
 
-    result = oscc_can_write(
-        OSCC_STEERING_DISABLE_CAN_ID,
-        (void *) &steering_disable,
-        sizeof(steering_disable) );
+            close( watchdog->timer_fd );
+            close( watchdog->stop_fd );
 
+            watchdog->timer_fd = UNINITIALIZED_SOCKET;
+            watchdog->stop_fd = UNINITIALIZED_SOCKET;
+            watchdog->started = false;
+        }
+    }
 
     return result;
 }
 
 
-void oscc_update_status( int sig, siginfo_t *siginfo, void *context )
+void * oscc_report_watchdog_thread( void * arg )
 {
-    struct can_frame rx_frame;
-    memset( &rx_frame, 0, sizeof(rx_frame) );
+    oscc_context_t * const context = arg;
+    report_watchdog_s * const watchdog = &context->report_watchdog;
+
+    struct pollfd poll_fds[] =
+    {
+        { .fd = watchdog->timer_fd, .events = POLLIN },
+        { .fd = watchdog->stop_fd, .events = POLLIN }
+    };
 
-    if ( global_oscc_can_socket >= 0 )
+    // Lets the stale callback use the functions without a context argument
+    global_current_context = context;
+
+    while ( atomic_load( &watchdog->running ) == true )
     {
-        int oscc_can_bytes = read( global_oscc_can_socket, &rx_frame, CAN_MTU );
+        struct timespec now;
+
+        clock_gettime( CLOCK_MONOTONIC, &now );
+
+        const uint64_t due_ns = oscc_report_watchdog_check(
+            context,
+            ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec );
+
+        // A single timer serves every stream, armed for whichever is due first
+        struct itimerspec timer =
+        {
+            .it_value = { .tv_sec = due_ns / 1000000000, .tv_nsec = due_ns % 1000000000 }
+        };
+
+        if ( timerfd_settime( watchdog->timer_fd, TFD_TIMER_ABSTIME, &timer, NULL ) < 0 )
+        {
+            perror( "Arming report watchdog timer failed:" );
 
-        while ( oscc_can_bytes > 0 )
+            break;
+        }
+
+        if ( poll( poll_fds, 2, -1 ) < 0 )
         {
-            if ( (rx_frame.data[0] == OSCC_MAGIC_BYTE_0)
-                && (rx_frame.data[1] == OSCC_MAGIC_BYTE_1) )
+            if ( errno == EINTR )
             {
-                if ( rx_frame.can_id == OSCC_STEERING_REPORT_CAN_ID )
-                {
-                    oscc_steering_report_s *steering_report =
-                        ( oscc_steering_report_s* ) rx_frame.data;
+                continue;
+            }
 
-                    if ( steering_report_callback != NULL )
-                    {
-                        steering_report_callback( steering_report );
-                    }
-                }
-                else if ( rx_frame.can_id == OSCC_THROTTLE_REPORT_CAN_ID )
-                {
-                    oscc_throttle_report_s *throttle_report =
-                        ( oscc_throttle_report_s* ) rx_frame.data;
+            perror( "Waiting on report watchdog timer failed:" );
 
-                    if ( throttle_report_callback != NULL )
-                    {
-                        throttle_report_callback( throttle_report );
-                    }
-                }
-                else if ( rx_frame.can_id == OSCC_BRAKE_REPORT_CAN_ID )
-                {
-                    oscc_brake_report_s *brake_report =
-                        ( oscc_brake_report_s* ) rx_frame.data;
+            break;
+        }
 
-                    if ( brake_report_callback != NULL )
-                    {
-                        brake_report_callback( brake_report );
-                    }
-                }
-                else if ( rx_frame.can_id == OSCC_FAULT_REPORT_CAN_ID )
-                {
-                    oscc_fault_report_s *fault_report =
-                        ( oscc_fault_report_s* ) rx_frame.data;
+        uint64_t expirations;
 
-                    if ( fault_report_callback != NULL )
-                    {
-                        fault_report_callback( fault_report );
-                    }
-                }
+        // Deadlines are checked again however the wait ended, the timer only
+        // needs its expirations cleared
+        if ( ((poll_fds[0].revents & POLLIN) != 0)
+            && (read( watchdog->timer_fd, &expirations, sizeof(expirations) ) < 0) )
+        {
+            perror( "Reading report watchdog timer failed:" );
+        }
+    }
+
+    return NULL;
+}
+
+
+uint64_t oscc_report_watchdog_check(
+    oscc_context_t * const context,
+    uint64_t now_ns )
+{
+    report_watchdog_s * const watchdog = &context->report_watchdog;
+
+    uint64_t next_due_ns = UINT64_MAX;
+
+    unsigned int i;
+
+    for ( i = 0; i < OSCC_REPORT_STREAM_COUNT; i++ )
+    {
+        const uint64_t deadline_ns =
+            (uint64_t) ( watchdog->period_multiple * (double) global_report_periods_ns[i] );
+
+        // Stale streams are looked at again one deadline on, by which time
+        // their reports may have resumed
+        uint64_t due_ns = now_ns + deadline_ns;
+
+        if ( atomic_load( &watchdog->stale[i] ) == false )
+        {
+            const uint64_t last_report_ns = atomic_load( &watchdog->last_report_ns[i] );
+
+            if ( (now_ns - last_report_ns) < deadline_ns )
+            {
+                due_ns = last_report_ns + deadline_ns;
             }
             else
             {
-                if ( obd_frame_callback != NULL && global_vehicle_can_socket < 0 )
+                bool expected = false;
+
+                if ( atomic_compare_exchange_strong( &watchdog->stale[i], &expected, true ) )
                 {
-                    obd_frame_callback( &rx_frame );
+                    if ( atomic_load( &watchdog->last_report_ns[i] ) != last_report_ns )
+                    {
+                        // A report arrived while the flag was being set
+                        atomic_store( &watchdog->stale[i], false );
+                        due_ns = now_ns;
+                    }
+                    else
+                    {
+                        if ( context->callbacks.report_stale != NULL )
+                        {
+                            context->callbacks.report_stale( (oscc_report_stream_t) i );
+                        }
+
+                        if ( watchdog->auto_disable == true )
+                        {
+                            (void) oscc_context_disable( context );
+                        }
+                    }
                 }
             }
+        }
 
-            oscc_can_bytes = read( global_oscc_can_socket, &rx_frame, CAN_MTU );
+        if ( due_ns < next_due_ns )
+        {
+            next_due_ns = due_ns;
         }
     }
 
-    if ( global_vehicle_can_socket >= 0 )
+    return next_due_ns;
+}
+
+
+void oscc_report_watchdog_feed(
+    oscc_context_t * const context,
+    canid_t can_id )
+{
+    report_watchdog_s * const watchdog = &context->report_watchdog;
+
+    if ( atomic_load_explicit( &watchdog->running, memory_order_relaxed ) == true )
     {
-        int vehicle_can_bytes = read( global_vehicle_can_socket, &rx_frame, CAN_MTU );
+        int stream = -1;
+
+        switch ( can_id )
+        {
+            case OSCC_BRAKE_REPORT_CAN_ID:
+                stream = OSCC_REPORT_STREAM_BRAKE;
+                break;
+
+            case OSCC_THROTTLE_REPORT_CAN_ID:
+                stream = OSCC_REPORT_STREAM_THROTTLE;
+                break;
+
+            case OSCC_STEERING_REPORT_CAN_ID:
+                stream = OSCC_REPORT_STREAM_STEERING;
+                break;
 
-        while( vehicle_can_bytes > 0 )
+            default:
+                break;
+        }
+
+        if ( stream >= 0 )
         {
-            if ( obd_frame_callback != NULL )
+            struct timespec now;
+
+            clock_gettime( CLOCK_MONOTONIC, &now );
+
+            // The time goes first so the watchdog never pairs a cleared flag
+            // with the silence that made it stale
+            atomic_store(
+                &watchdog->last_report_ns[stream],
+                ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec );
+
+            if ( atomic_load_explicit( &watchdog->stale[stream], memory_order_relaxed ) == true )
             {
-                obd_frame_callback( &rx_frame );
+                atomic_store( &watchdog->stale[stream], false );
             }
-
-            vehicle_can_bytes = read( global_vehicle_can_socket, &rx_frame, CAN_MTU );
         }
     }
 }
 
-oscc_result_t oscc_can_write( long id, void *msg, unsigned int dlc )
+oscc_result_t oscc_confirm_state_change(
+    oscc_context_t * const context,
+    bool enable,
+    unsigned int timeout_ms,
+    oscc_confirmation_s * const confirmation )
 {
     oscc_result_t result = OSCC_ERROR;
 
+    enable_confirmation_s * const pending = &context->enable_confirmation;
+
+    bool expected = false;
 
-    if ( global_oscc_can_socket >= 0 )
+    // Waiting would mean draining the sockets behind the caller's event loop
+    if ( (confirmation == NULL)
+        || (context->receive_mode == OSCC_RECEIVE_MODE_EXTERNAL)
+        || (atomic_compare_exchange_strong( &pending->busy, &expected, true ) == false) )
     {
-        struct can_frame tx_frame;
+        return result;
+    }
+
+    memset( confirmation, 0, sizeof(*confirmation) );
 
-        memset( &tx_frame, 0, sizeof(tx_frame) );
-        tx_frame.can_id = id;
-        tx_frame.can_dlc = dlc;
-        memcpy( tx_frame.data, msg, dlc );
+    if ( pending->event_fd < 0 )
+    {
+        pending->event_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    }
 
-        int ret = write( global_oscc_can_socket, &tx_frame, sizeof(tx_frame) );
+    if ( pending->event_fd < 0 )
+    {
+        perror( "Creating confirmation descriptor failed:" );
+    }
+    else
+    {
+        unsigned int i;
 
-        if ( ret > 0 )
+        for ( i = 0; i < OSCC_REPORT_STREAM_COUNT; i++ )
         {
-            result = OSCC_OK;
+            atomic_store( &pending->confirmed_ns[i], 0 );
         }
-        else
+
+        atomic_store( &pending->target, enable );
+
+        struct timespec now;
+
+        clock_gettime( CLOCK_MONOTONIC, &now );
+
+        const uint64_t sent_ns = ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec;
+        const uint64_t deadline_ns = sent_ns + ( (uint64_t) timeout_ms * UINT64_C(1000000) );
+
+        // Reports decoded from here on are matched, so none sent in reply to
+        // the frames can be missed. The filters let the reports through before
+        // the frames go out.
+        atomic_store( &pending->waiting, true );
+
+        result = oscc_update_can_filters( context );
+
+        if ( result == OSCC_OK )
         {
-            perror( "Could not write to socket:" );
+            result = enable ? oscc_context_enable( context ) : oscc_context_disable( context );
         }
-    }
 
+        while ( result == OSCC_OK )
+        {
+            unsigned int confirmed = 0;
 
-    return result;
-}
+            for ( i = 0; i < OSCC_REPORT_STREAM_COUNT; i++ )
+            {
+                const uint64_t confirmed_ns = atomic_load( &pending->confirmed_ns[i] );
 
+                if ( confirmed_ns != 0 )
+                {
+                    confirmation->confirmed[i] = true;
+                    confirmation->latency_ns[i] = confirmed_ns - sent_ns;
+                    confirmed++;
+                }
+            }
 
-oscc_result_t register_can_signal( )
-{
-    oscc_result_t result = OSCC_ERROR;
+            clock_gettime( CLOCK_MONOTONIC, &now );
 
-    struct sigaction sig;
-    memset( &sig, 0, sizeof(sig) );
+            const uint64_t now_ns = ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec;
 
-    sigemptyset( &sig.sa_mask );
+            if ( confirmed == OSCC_REPORT_STREAM_COUNT )
+            {
+                break;
+            }
+            else if ( now_ns >= deadline_ns )
+            {
+                result = OSCC_WARNING;
 
-    sig.sa_sigaction = oscc_update_status;
+                break;
+            }
 
-    sig.sa_flags = SA_SIGINFO | SA_RESTART;
+            const int timeout = (int) ( (deadline_ns - now_ns + 999999) / 1000000 );
 
-    if( sigaction( SIGIO, &sig, NULL ) == 0 )
-    {
-        result = OSCC_OK;
+            struct pollfd poll_fd = { .fd = pending->event_fd, .events = POLLIN };
+
+            if ( (poll( &poll_fd, 1, timeout ) > 0) && ((poll_fd.revents & POLLIN) != 0) )
+            {
+                uint64_t reports;
+
+                (void) eventfd_read( pending->event_fd, &reports );
+            }
+        }
+
+        atomic_store( &pending->waiting, false );
+
+        (void) oscc_update_can_filters( context );
     }
 
+    atomic_store( &pending->busy, false );
+
     return result;
 }
 
 
-oscc_result_t oscc_async_enable( int socket )
+void oscc_confirm_report(
+    oscc_context_t * const context,
+    oscc_report_stream_t stream,
+    bool enabled )
 {
-    oscc_result_t result = OSCC_ERROR;
-
-    int ret = fcntl( socket, F_SETOWN, getpid( ) );
+    enable_confirmation_s * const pending = &context->enable_confirmation;
 
-    if ( ret < 0 )
+    if ( (atomic_load_explicit( &pending->waiting, memory_order_relaxed ) == true)
+        && (atomic_load( &pending->target ) == enabled)
+        && (atomic_load_explicit( &pending->confirmed_ns[stream], memory_order_relaxed ) == 0) )
     {
-        perror( "Setting owner process of socket failed:" );
-    }
-    else
-    {
-        result = OSCC_OK;
+        struct timespec now;
+
+        clock_gettime( CLOCK_MONOTONIC, &now );
+
+        uint_fast64_t expected = 0;
+
+        // Only the first report showing the state counts
+        if ( atomic_compare_exchange_strong(
+                &pending->confirmed_ns[stream],
+                &expected,
+                ( (uint64_t) now.tv_sec * UINT64_C(1000000000) ) + (uint64_t) now.tv_nsec ) )
+        {
+            eventfd_write( pending->event_fd, 1 );
+        }
     }
+}
+
+void oscc_transmit_pending( oscc_context_t * const context )
+{
+    transmit_scheduler_s * const scheduler = &context->transmit_scheduler;
 
+    struct can_frame frames[TRANSMIT_SLOT_COUNT];
+    uint_fast64_t taken[TRANSMIT_SLOT_COUNT];
+    unsigned int count = 0;
 
-    if ( result == OSCC_OK )
+    unsigned int i;
+
+    for ( i = 0; i < TRANSMIT_SLOT_COUNT; i++ )
     {
-        ret = fcntl( socket, F_SETFL, FASYNC | O_NONBLOCK );
+        taken[i] = atomic_fetch_and( &scheduler->slots[i], ~TRANSMIT_SLOT_PENDING );
 
-        if ( ret < 0 )
+        if ( (taken[i] & TRANSMIT_SLOT_PENDING) != 0 )
         {
-            perror( "Setting nonblocking asynchronous socket I/O failed:" );
+            uint32_t bits = (uint32_t) taken[i];
+            float command;
 
-            result = OSCC_ERROR;
+            memcpy( &command, &bits, sizeof(command) );
+
+            oscc_build_command( &frames[count++], (transmit_slot_t) i, command );
         }
     }
 
+    if ( (count > 0) && (oscc_can_write_frames( context, frames, count ) != OSCC_OK) )
+    {
+        // Send again on the next tick unless a newer command replaced them
+        for ( i = 0; i < TRANSMIT_SLOT_COUNT; i++ )
+        {
+            if ( (taken[i] & TRANSMIT_SLOT_PENDING) != 0 )
+            {
+                uint_fast64_t expected = taken[i] & ~TRANSMIT_SLOT_PENDING;
 
-    return result;
+                atomic_compare_exchange_strong( &scheduler->slots[i], &expected, taken[i] );
+            }
+        }
+    }
+}
+
+
+void oscc_schedule_command(
+    oscc_context_t * const context,
+    transmit_slot_t slot,
+    double command )
+{
+    // Commands are sent as floats, so nothing is lost by storing one
+    const float value = (float) command;
+    uint32_t bits;
+
+    memcpy( &bits, &value, sizeof(bits) );
+
+    atomic_store_explicit(
+        &context->transmit_scheduler.slots[slot],
+        TRANSMIT_SLOT_PENDING | bits,
+        memory_order_release );
+}
+
+
+void oscc_queue_frame(
+    oscc_context_t * const context,
+    oscc_rx_frame_s * const rx_frame )
+{
+    // A full queue means the callbacks are falling behind; newer frames are
+    // dropped rather than stalling the sockets
+    if ( frame_queue_push( &context->receive_engine.queue, rx_frame ) == false )
+    {
+        oscc_count_drop( context, rx_frame );
+    }
 }
 
 
-oscc_result_t oscc_search_can( can_contains_s(*search_callback)( const char * ),
-                               bool search_oscc )
+oscc_result_t oscc_search_can(
+    oscc_context_t * const context,
+    can_contains_s(*search_callback)( oscc_context_t *, const char *, can_contains_s ),
+    bool search_oscc )
 {
     oscc_result_t result = OSCC_OK;
 
@@ -646,7 +5870,32 @@ oscc_result_t oscc_search_can( can_contains_s(*search_callback)( const char * ),
         result = construct_interfaces_list( &dev_list );
     }
 
-    //temp_contents is the temporary storage of the current CAN channel
+    const char *channels[CAN_DETECTION_CHANNELS_MAX];
+    can_contains_s detected[CAN_DETECTION_CHANNELS_MAX];
+    size_t channel_count = 0;
+
+    uint i;
+
+    for( i = 0; (result == OSCC_OK) && (i < dev_list.size); i++ )
+    {
+        // A bus already driven by another context is never shared
+        if( oscc_channel_claimed( context, dev_list.name[i] ) == false )
+        {
+            channels[channel_count++] = dev_list.name[i];
+        }
+    }
+
+    if( result == OSCC_OK && channel_count > 0 )
+    {
+        result = can_detection_all(
+            channels,
+            channel_count,
+            detected,
+            context->obd_vehicle,
+            search_oscc );
+    }
+
+    //temp_contents is what the callback took from the current CAN channel
     //all_contents is the sum of all channels searched
     can_contains_s temp_contents;
     can_contains_s all_contents =
@@ -655,88 +5904,103 @@ oscc_result_t oscc_search_can( can_contains_s(*search_callback)( const char * ),
         .has_vehicle = false
     };
 
-    uint i;
-
-    for( i = 0; i < dev_list.size; i++ )
+    for( i = 0; (result == OSCC_OK) && (i < channel_count); i++ )
     {
-        if ( strstr( dev_list.name[i], "can") != NULL && result == OSCC_OK )
-        {
-            temp_contents = search_callback( dev_list.name[i] );
+        temp_contents = search_callback( context, channels[i], detected[i] );
 
-            all_contents.is_oscc |= temp_contents.is_oscc;
+        all_contents.is_oscc |= temp_contents.is_oscc;
 
-            all_contents.has_vehicle |= temp_contents.has_vehicle;
+        all_contents.has_vehicle |= temp_contents.has_vehicle;
 
-            //Leave the while loop if both requirements are met
-            if( all_contents.is_oscc && all_contents.has_vehicle )
-            {
-                break;
-            }
+        //Leave the loop if both requirements are met
+        if( all_contents.is_oscc && all_contents.has_vehicle )
+        {
+            break;
         }
     }
 
     if( dev_list.name != NULL )
     {
-        result = clear_device_names( &dev_list );
+        oscc_result_t clear_result = clear_device_names( &dev_list );
+
+        if( result == OSCC_OK )
+        {
+            result = clear_result;
+        }
     }
 
     return result;
 }
 
 
-can_contains_s auto_init_all_can( const char *can_channel )
+can_contains_s auto_init_all_can(
+    oscc_context_t * const context,
+    const char *can_channel,
+    can_contains_s contents )
 {
-    if ( can_channel == NULL )
+    can_contains_s initialized =
     {
-        can_contains_s contents =
-        {
-              .is_oscc = false,
-              .has_vehicle = false
-        };
+        .is_oscc = false,
+        .has_vehicle = false
+    };
 
-        return contents;
+    if ( can_channel == NULL )
+    {
+        return initialized;
     }
 
-    can_contains_s contents = can_detection( can_channel );
-
-    if( contents.is_oscc )
+    // An OSCC channel carrying vehicle CAN as well covers both needs, so the
+    // vehicle frames are taken from the OSCC socket
+    if( contents.is_oscc && context->oscc_can_socket < 0 )
     {
-        init_oscc_can( can_channel );
+        if( init_oscc_can( context, can_channel ) == OSCC_OK )
+        {
+            initialized = contents;
+        }
     }
-    else if( contents.has_vehicle )
+    else if( contents.has_vehicle && context->vehicle_can_socket < 0 )
     {
-        init_vehicle_can( can_channel );
+        if( init_vehicle_can( context, can_channel ) == OSCC_OK )
+        {
+            initialized.has_vehicle = true;
+        }
     }
 
-    return contents;
+    return initialized;
 }
 
 
-can_contains_s auto_init_vehicle_can( const char *can_channel )
+can_contains_s auto_init_vehicle_can(
+    oscc_context_t * const context,
+    const char *can_channel,
+    can_contains_s contents )
 {
-    if ( can_channel == NULL )
+    can_contains_s initialized =
     {
-        can_contains_s contents =
-        {
-              .is_oscc = false,
-              .has_vehicle = false
-        };
+        .is_oscc = false,
+        .has_vehicle = false
+    };
 
-        return contents;
+    if ( can_channel == NULL )
+    {
+        return initialized;
     }
 
-    can_contains_s contents = can_detection( can_channel );
-
-    if( contents.has_vehicle )
+    if( contents.has_vehicle && context->vehicle_can_socket < 0 )
     {
-      init_vehicle_can( can_channel );
+        if( init_vehicle_can( context, can_channel ) == OSCC_OK )
+        {
+            initialized.has_vehicle = true;
+        }
     }
 
-    return contents;
+    return initialized;
 }
 
 
-oscc_result_t init_oscc_can( const char *can_channel )
+oscc_result_t init_oscc_can(
+    oscc_context_t * const context,
+    const char *can_channel )
 {
     int result = OSCC_ERROR;
 
@@ -744,19 +6008,78 @@ oscc_result_t init_oscc_can( const char *can_channel )
     {
         printf( "Assigning OSCC CAN Channel to: %s\n", can_channel );
 
-        global_oscc_can_socket = init_can_socket( can_channel, NULL );
+        context->oscc_can_socket = init_can_socket( can_channel, NULL );
     }
 
-    if( can_channel != NULL && global_oscc_can_socket >= 0 )
+    if( can_channel != NULL && context->oscc_can_socket >= 0 )
     {
-        result = OSCC_OK;
+        strncpy( context->oscc_can_channel, can_channel, IFNAMSIZ - 1 );
+        context->oscc_can_channel[IFNAMSIZ - 1] = '\0';
+
+        (void) oscc_enable_timestamps( context->oscc_can_socket );
+        (void) oscc_enable_overflow_counter( context->oscc_can_socket );
+
+        context->priority_lane.socket = init_priority_socket( can_channel );
+
+        result = oscc_update_can_filters( context );
     }
 
     return result;
 }
 
 
-oscc_result_t init_vehicle_can( const char *can_channel )
+int init_priority_socket( const char *can_channel )
+{
+    int sock = init_can_socket( can_channel, NULL );
+
+    if( sock >= 0 )
+    {
+        const canid_t priority_ids[] =
+        {
+            OSCC_BRAKE_ENABLE_CAN_ID,
+            OSCC_BRAKE_DISABLE_CAN_ID,
+            OSCC_THROTTLE_ENABLE_CAN_ID,
+            OSCC_THROTTLE_DISABLE_CAN_ID,
+            OSCC_STEERING_ENABLE_CAN_ID,
+            OSCC_STEERING_DISABLE_CAN_ID
+        };
+
+        struct can_filter filters[sizeof(priority_ids) / sizeof(priority_ids[0])];
+        unsigned int count = 0;
+
+        size_t i;
+
+        for( i = 0; i < (sizeof(priority_ids) / sizeof(priority_ids[0])); i++ )
+        {
+            (void) oscc_add_can_filter( filters, &count, priority_ids[i] );
+        }
+
+        int priority = PRIORITY_LANE_SO_PRIORITY;
+        int receive_own = 1;
+        int timestamps = 1;
+
+        // The socket only ever receives the echoes of its own frames, stamped
+        // with the same clock their requests are
+        if( (setsockopt( sock, SOL_SOCKET, SO_PRIORITY, &priority, sizeof(priority) ) < 0)
+            || (setsockopt( sock, SOL_CAN_RAW, CAN_RAW_RECV_OWN_MSGS, &receive_own, sizeof(receive_own) ) < 0)
+            || (setsockopt( sock, SOL_CAN_RAW, CAN_RAW_FILTER, filters, count * sizeof(filters[0]) ) < 0)
+            || (setsockopt( sock, SOL_SOCKET, SO_TIMESTAMPNS, &timestamps, sizeof(timestamps) ) < 0)
+            || (fcntl( sock, F_SETFL, O_NONBLOCK ) < 0) )
+        {
+            perror( "Warning: Configuring priority CAN socket failed:" );
+
+            close( sock );
+            sock = UNINITIALIZED_SOCKET;
+        }
+    }
+
+    return sock;
+}
+
+
+oscc_result_t init_vehicle_can(
+    oscc_context_t * const context,
+    const char *can_channel )
 {
     int result = OSCC_ERROR;
 
@@ -764,12 +6087,18 @@ oscc_result_t init_vehicle_can( const char *can_channel )
     {
           printf( "Assigning Vehicle CAN Channel to: %s\n", can_channel );
 
-          global_vehicle_can_socket = init_can_socket( can_channel, NULL );
+          context->vehicle_can_socket = init_can_socket( can_channel, NULL );
     }
 
-    if( can_channel != NULL && global_vehicle_can_socket >= 0 )
+    if( can_channel != NULL && context->vehicle_can_socket >= 0 )
     {
-        result = OSCC_OK;
+        strncpy( context->vehicle_can_channel, can_channel, IFNAMSIZ - 1 );
+        context->vehicle_can_channel[IFNAMSIZ - 1] = '\0';
+
+        (void) oscc_enable_timestamps( context->vehicle_can_socket );
+        (void) oscc_enable_overflow_counter( context->vehicle_can_socket );
+
+        result = oscc_update_can_filters( context );
     }
 
     return result;
@@ -852,263 +6181,454 @@ int init_can_socket( const char *can_channel,
 }
 
 
-can_contains_s can_detection( const char *can_channel )
+can_contains_s can_detection(
+    const char *can_channel,
+    const obd_vehicle_s * const obd_vehicle )
 {
-    if( can_channel == NULL )
+    can_contains_s detection =
     {
-        can_contains_s detection =
-        {
-            .is_oscc = false,
-            .has_vehicle = false
-        };
+        .is_oscc = false,
+        .has_vehicle = false
+    };
 
-        return detection;
+    if( can_channel != NULL )
+    {
+        (void) can_detection_all( &can_channel, 1, &detection, obd_vehicle, true );
     }
 
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = CAN_MESSAGE_TIMEOUT;
+    return detection;
+}
 
-    int sock = init_can_socket( can_channel, &timeout );
 
-    vehicle_can_desc_s vehicle_detection =
+oscc_result_t can_detection_all(
+    const char * const * can_channels,
+    size_t count,
+    can_contains_s * const detections,
+    const obd_vehicle_s * const obd_vehicle,
+    bool search_oscc )
+{
+    if( (can_channels == NULL)
+        || (detections == NULL)
+        || (count > CAN_DETECTION_CHANNELS_MAX) )
     {
-        .has_steering_angle = false,
-        .has_brake_pressure = false,
-        .has_wheel_speed = false
-    };
+        return OSCC_ERROR;
+    }
 
-    oscc_can_desc_s oscc_detection =
-    {
-        .has_accel_report = false,
-        .has_steer_report = false,
-        .has_brake_report = false
-    };
+    can_probe_s probes[CAN_DETECTION_CHANNELS_MAX];
+    struct pollfd poll_fds[CAN_DETECTION_CHANNELS_MAX];
+
+    long long start = monotonic_time_ms( );
+    long long deadline = start + CAN_DETECTION_TIMEOUT;
 
-    uint i = 0;
+    size_t i;
 
-    for( i = 0; i < MAX_CAN_IDS; i++ )
+    for( i = 0; i < count; i++ )
     {
-        struct can_frame rx_frame;
-        memset( &rx_frame, 0, sizeof( rx_frame ) );
-        int recv_bytes = 0;
+        memset( &probes[i], 0, sizeof(probes[i]) );
 
-        recv_bytes = read( sock, &rx_frame, sizeof( rx_frame ) );
+        probes[i].socket = can_probe_open( can_channels[i], obd_vehicle );
+        probes[i].obd_vehicle = obd_vehicle;
+        probes[i].last_frame_ms = start;
+        probes[i].done = ( probes[i].socket < 0 );
 
-        if( recv_bytes == CAN_MTU || recv_bytes == CANFD_MTU )
+        poll_fds[i].fd = probes[i].socket;
+        poll_fds[i].events = POLLIN;
+    }
+
+    size_t active = count;
+
+    while( active > 0 )
+    {
+        long long now = monotonic_time_ms( );
+
+        if( now >= deadline )
         {
-            if ( (rx_frame.can_id < 0x100) &&
-                 (rx_frame.data[0] == OSCC_MAGIC_BYTE_0) &&
-                 (rx_frame.data[1] == OSCC_MAGIC_BYTE_1) )
-            {
-              oscc_detection.has_brake_report |=
-                  ( (rx_frame.can_id == OSCC_BRAKE_REPORT_CAN_ID) );
+            break;
+        }
+
+        // Sleep until a probe has a frame, goes quiet for too long or the
+        // whole search runs out of time, whichever comes first
+        long long wake = deadline;
 
-              oscc_detection.has_steer_report |=
-                  ( (rx_frame.can_id == OSCC_STEERING_REPORT_CAN_ID) );
+        for( i = 0; i < count; i++ )
+        {
+            // A negative descriptor is ignored by poll
+            poll_fds[i].fd = probes[i].done ? -1 : probes[i].socket;
 
-              oscc_detection.has_accel_report |=
-                  ( (rx_frame.can_id == OSCC_THROTTLE_REPORT_CAN_ID) );
+            if( !probes[i].done
+                && (probes[i].last_frame_ms + CAN_MESSAGE_TIMEOUT) < wake )
+            {
+                wake = probes[i].last_frame_ms + CAN_MESSAGE_TIMEOUT;
             }
+        }
 
-            vehicle_detection.has_brake_pressure |=
-                ( rx_frame.can_id == KIA_SOUL_OBD_BRAKE_PRESSURE_CAN_ID );
+        int ready = poll( poll_fds, count, (wake > now) ? (int) (wake - now) : 0 );
 
-            vehicle_detection.has_steering_angle |=
-                ( rx_frame.can_id == KIA_SOUL_OBD_STEERING_WHEEL_ANGLE_CAN_ID );
+        if( ready < 0 && errno != EINTR )
+        {
+            perror( "Polling CAN channels failed:" );
 
-            vehicle_detection.has_wheel_speed |=
-                ( rx_frame.can_id == KIA_SOUL_OBD_WHEEL_SPEED_CAN_ID );
+            break;
         }
-    }
-
-    close( sock );
 
-    can_contains_s detection =
-    {
-        .is_oscc = oscc_detection.has_brake_report &&
-                   oscc_detection.has_steer_report &&
-                   oscc_detection.has_accel_report,
-        .has_vehicle = vehicle_detection.has_brake_pressure &&
-                       vehicle_detection.has_steering_angle &&
-                       vehicle_detection.has_wheel_speed
-    };
+        now = monotonic_time_ms( );
 
-    return detection;
-}
+        active = 0;
 
+        for( i = 0; i < count; i++ )
+        {
+            if( probes[i].done )
+            {
+                continue;
+            }
 
-oscc_result_t construct_interfaces_list( device_names_s * const names_ptr )
-{
-    FILE *file_handler;
-    char buffer[512];
-    oscc_result_t result = OSCC_OK;
+            if( (ready > 0) && (poll_fds[i].revents & POLLIN) )
+            {
+                can_probe_read( &probes[i], now );
+            }
 
-    file_handler = fopen( "/proc/net/dev", "r" );
-    if (!file_handler) {
-        perror( "Cannot read: /proc/net/dev" );
+            can_contains_s contents = can_probe_contents( &probes[i] );
 
-        result = OSCC_ERROR;
+            // A channel is finished once it has shown everything it could
+            // offer, has given the old per-channel frame budget, or has
+            // gone silent
+            if( (contents.is_oscc || !search_oscc) && contents.has_vehicle )
+            {
+                probes[i].done = true;
+            }
+            else if( probes[i].frames >= MAX_CAN_IDS )
+            {
+                probes[i].done = true;
+            }
+            else if( (now - probes[i].last_frame_ms) >= CAN_MESSAGE_TIMEOUT )
+            {
+                probes[i].done = true;
+            }
+            else
+            {
+                active++;
+            }
+        }
     }
 
-    if( result == OSCC_OK && names_ptr == NULL )
+    for( i = 0; i < count; i++ )
     {
-        result = OSCC_ERROR;
+        detections[i] = can_probe_contents( &probes[i] );
+
+        if( probes[i].socket >= 0 )
+        {
+            close( probes[i].socket );
+        }
     }
 
-    int lines = 0;
+    return OSCC_OK;
+}
+
 
-    if( result == OSCC_OK )
+int can_probe_open(
+    const char *can_channel,
+    const obd_vehicle_s * const obd_vehicle )
+{
+    int sock = init_can_socket( can_channel, NULL );
+
+    if( sock >= 0 )
     {
-        while ( fgets( buffer, sizeof( buffer ), file_handler ) ) {
-            ++lines;
-        }
+        // Only the frames that identify a channel are of interest
+        const canid_t signatures[] =
+        {
+            OSCC_BRAKE_REPORT_CAN_ID,
+            OSCC_STEERING_REPORT_CAN_ID,
+            OSCC_THROTTLE_REPORT_CAN_ID
+        };
+
+        struct can_filter filters[CAN_FILTER_COUNT_MAX];
+        unsigned int count = 0;
 
-        names_ptr->name = (char**) malloc(lines * sizeof(char*));
+        size_t i;
 
-        uint i;
+        for( i = 0; i < (sizeof(signatures) / sizeof(signatures[0])); i++ )
+        {
+            (void) oscc_add_can_filter( filters, &count, signatures[i] );
+        }
 
-        for ( i = 0; i < lines; i++ )
+        for( i = 0; i < obd_vehicle->frame_count; i++ )
         {
-            names_ptr->name[i] = (char*) malloc(IFNAMSIZ * sizeof(char));
+            (void) oscc_add_can_filter( filters, &count, obd_vehicle->frames[i].can_id );
         }
 
-        rewind( file_handler );
+        if( (setsockopt( sock, SOL_CAN_RAW, CAN_RAW_FILTER, filters, count * sizeof(filters[0]) ) < 0)
+            || (fcntl( sock, F_SETFL, O_NONBLOCK ) < 0) )
+        {
+            perror( "Configuring CAN detection socket failed:" );
 
-        //Consume the first two lines since they are headers
-        fgets( buffer, sizeof( buffer ), file_handler );
-        fgets( buffer, sizeof( buffer ), file_handler );
+            close( sock );
+            sock = UNINITIALIZED_SOCKET;
+        }
     }
 
-    char* socket_name = calloc( IFNAMSIZ, sizeof(char) );
+    return sock;
+}
 
-    if( !socket_name )
-    {
-        result = OSCC_ERROR;
-    }
 
-    if( result == OSCC_OK )
+void can_probe_read( can_probe_s * const probe, long long now_ms )
+{
+    struct can_frame rx_frame;
+
+    while( probe->frames < MAX_CAN_IDS )
     {
-        uint size = 0;
+        int recv_bytes = read( probe->socket, &rx_frame, sizeof( rx_frame ) );
 
-        while ( size < lines && fgets( buffer, sizeof( buffer ), file_handler ) ) {
+        if( recv_bytes != CAN_MTU )
+        {
+            break;
+        }
 
-            result = get_device_name( buffer, socket_name );
+        probe->frames++;
+        probe->last_frame_ms = now_ms;
 
-            if( result == OSCC_OK )
-            {
-                strncpy( names_ptr->name[size], socket_name, IFNAMSIZ );
+        if ( (rx_frame.can_id < 0x100) &&
+             (rx_frame.data[0] == OSCC_MAGIC_BYTE_0) &&
+             (rx_frame.data[1] == OSCC_MAGIC_BYTE_1) )
+        {
+          probe->oscc.has_brake_report |=
+              ( (rx_frame.can_id == OSCC_BRAKE_REPORT_CAN_ID) );
 
-                size++;
-            }
+          probe->oscc.has_steer_report |=
+              ( (rx_frame.can_id == OSCC_STEERING_REPORT_CAN_ID) );
+
+          probe->oscc.has_accel_report |=
+              ( (rx_frame.can_id == OSCC_THROTTLE_REPORT_CAN_ID) );
         }
 
-        free( socket_name );
+        probe->vehicle.has_brake_pressure |= obd_frame_carries(
+            probe->obd_vehicle, rx_frame.can_id, OSCC_OBD_SIGNAL_BRAKE_PRESSURE );
+
+        probe->vehicle.has_steering_angle |= obd_frame_carries(
+            probe->obd_vehicle, rx_frame.can_id, OSCC_OBD_SIGNAL_STEERING_WHEEL_ANGLE );
 
-        names_ptr->size = size;
+        probe->vehicle.has_wheel_speed |= obd_frame_carries(
+            probe->obd_vehicle, rx_frame.can_id, OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT );
     }
+}
 
-    fclose( file_handler );
 
-    return result;
+can_contains_s can_probe_contents( const can_probe_s * const probe )
+{
+    can_contains_s detection =
+    {
+        .is_oscc = probe->oscc.has_brake_report &&
+                   probe->oscc.has_steer_report &&
+                   probe->oscc.has_accel_report,
+        .has_vehicle = probe->vehicle.has_brake_pressure &&
+                       probe->vehicle.has_steering_angle &&
+                       probe->vehicle.has_wheel_speed
+    };
+
+    return detection;
 }
 
-oscc_result_t clear_device_names( device_names_s * const names_ptr )
+
+long long monotonic_time_ms( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( (long long) now.tv_sec * 1000 ) + ( now.tv_nsec / 1000000 );
+}
+
+
+oscc_result_t construct_interfaces_list( device_names_s * const names_ptr )
 {
     oscc_result_t result = OSCC_OK;
 
     if( names_ptr == NULL )
     {
+        return OSCC_ERROR;
+    }
+
+    names_ptr->name = NULL;
+    names_ptr->size = 0;
+
+    int sock = socket( AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE );
+
+    if( sock < 0 )
+    {
+        perror( "Opening netlink socket failed:" );
+
         result = OSCC_ERROR;
     }
-    else
+
+    struct
     {
-        uint i;
+        struct nlmsghdr header;
+        struct ifinfomsg info;
+    } request;
+
+    memset( &request, 0, sizeof(request) );
+    request.header.nlmsg_len = NLMSG_LENGTH( sizeof(request.info) );
+    request.header.nlmsg_type = RTM_GETLINK;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = 1;
+    request.info.ifi_family = AF_UNSPEC;
+
+    if( result == OSCC_OK
+        && send( sock, &request, request.header.nlmsg_len, 0 ) < 0 )
+    {
+        perror( "Requesting network interfaces failed:" );
 
-        for ( i = 0; i < names_ptr->size; i++ )
-        {
-            if( names_ptr->name[i] != NULL )
-            {
-                free( names_ptr->name[i] );
+        result = OSCC_ERROR;
+    }
 
-                names_ptr->name[i] = NULL;
-            }
+    char found[CAN_DETECTION_CHANNELS_MAX][IFNAMSIZ];
+    size_t count = 0;
+    bool done = false;
 
-        }
+    while( result == OSCC_OK && done == false )
+    {
+        char buffer[NETLINK_BUFFER_SIZE] __attribute__(( aligned( NLMSG_ALIGNTO ) ));
 
-        if( names_ptr->name != NULL )
+        ssize_t length = recv( sock, buffer, sizeof(buffer), 0 );
+
+        if( length <= 0 )
         {
-            free( names_ptr->name );
+            perror( "Reading network interfaces failed:" );
 
-            names_ptr->name = NULL;
+            result = OSCC_ERROR;
+            break;
         }
 
-    }
+        struct nlmsghdr *message;
 
-    return result;
-}
+        for( message = (struct nlmsghdr *) buffer;
+             NLMSG_OK( message, (size_t) length );
+             message = NLMSG_NEXT( message, length ) )
+        {
+            if( message->nlmsg_type == NLMSG_DONE )
+            {
+                done = true;
+                break;
+            }
+            else if( message->nlmsg_type == NLMSG_ERROR )
+            {
+                printf( "Error: Network interface request was rejected\n" );
+
+                result = OSCC_ERROR;
+                break;
+            }
+            else if( message->nlmsg_type != RTM_NEWLINK )
+            {
+                continue;
+            }
 
+            struct ifinfomsg *info = NLMSG_DATA( message );
 
-oscc_result_t get_device_name( char * string, char * const name )
-{
-    oscc_result_t result = OSCC_OK;
+            // Any CAN device that is up, whatever its driver named it
+            if( (info->ifi_type != ARPHRD_CAN)
+                || ((info->ifi_flags & IFF_UP) == 0)
+                || (count >= CAN_DETECTION_CHANNELS_MAX) )
+            {
+                continue;
+            }
 
-    if( name == NULL || string == NULL )
-    {
-        result = OSCC_ERROR;
+            struct rtattr *attribute;
+            int attributes_length = IFLA_PAYLOAD( message );
+
+            for( attribute = IFLA_RTA( info );
+                 RTA_OK( attribute, attributes_length );
+                 attribute = RTA_NEXT( attribute, attributes_length ) )
+            {
+                if( attribute->rta_type == IFLA_IFNAME )
+                {
+                    strncpy( found[count], RTA_DATA( attribute ), IFNAMSIZ - 1 );
+                    found[count][IFNAMSIZ - 1] = '\0';
+                    count++;
+
+                    break;
+                }
+            }
+        }
     }
 
-    if( result == OSCC_OK )
+    if( sock >= 0 )
     {
-        size_t span = strcspn(string, ":");
-
-        char temp_name[IFNAMSIZ];
+        close( sock );
+    }
 
-        strncpy( temp_name, string, span );
+    // The pointer table and the names it points to share one allocation so
+    // the whole list is released with a single free
+    if( result == OSCC_OK && count > 0 )
+    {
+        char *arena = malloc( count * (sizeof(char *) + IFNAMSIZ) );
 
-        if( span <= IFNAMSIZ )
+        if( arena == NULL )
         {
-            temp_name[span] = '\0';
+            result = OSCC_ERROR;
         }
+        else
+        {
+            names_ptr->name = (char **) arena;
 
-        size_t leading_spaces = strspn( temp_name, " " );
+            char *names = arena + ( count * sizeof(char *) );
 
-        if( leading_spaces != 0 )
-        {
-            char new_name[IFNAMSIZ];
+            size_t i;
+
+            for( i = 0; i < count; i++ )
+            {
+                names_ptr->name[i] = names + ( i * IFNAMSIZ );
 
-            strncpy( name, temp_name + leading_spaces, span - leading_spaces + 1 );
+                memcpy( names_ptr->name[i], found[i], IFNAMSIZ );
+            }
 
-            new_name[span - leading_spaces] = '\0';
-        }
-        else
-        {
-            strncpy( name, temp_name, span );
+            names_ptr->size = count;
         }
     }
 
     return result;
 }
 
-static oscc_result_t get_wheel_speed(
+oscc_result_t clear_device_names( device_names_s * const names_ptr )
+{
+    oscc_result_t result = OSCC_OK;
+
+    if( names_ptr == NULL )
+    {
+        result = OSCC_ERROR;
+    }
+    else
+    {
+        free( names_ptr->name );
+
+        names_ptr->name = NULL;
+        names_ptr->size = 0;
+    }
+
+    return result;
+}
+
+
+static oscc_result_t get_obd_signal(
     struct can_frame const * const frame,
-    double * wheel_speed,
-    const size_t offset)
+    oscc_obd_signal_t signal,
+    double * value)
 {
-    if((frame == NULL) || (wheel_speed == NULL))
+    if((frame == NULL) || (value == NULL))
     {
         return OSCC_ERROR;
     }
 
-    if(frame->can_id != KIA_SOUL_OBD_WHEEL_SPEED_CAN_ID)
+    const obd_vehicle_s * const obd_vehicle = oscc_decoding_context()->obd_vehicle;
+
+    if(obd_frame_carries(obd_vehicle, frame->can_id, signal) == false)
     {
         return OSCC_ERROR;
     }
 
-    uint16_t raw = ((frame->data[offset + 1] & 0x0F) << 8) | frame->data[offset];
+    double values[OSCC_OBD_SIGNAL_COUNT];
+
+    (void) obd_frame_decode(obd_vehicle_frame(obd_vehicle, frame->can_id), frame, values);
 
-    // 10^-1 precision, raw / 32.0
-    *wheel_speed = (double)((int)((double)raw / 3.2) / 10.0);
+    *value = values[signal];
 
     return OSCC_OK;
 }
@@ -1117,11 +6637,7 @@ oscc_result_t get_wheel_speed_right_rear(
     struct can_frame const * const frame,
     double * wheel_speed_right_rear)
 {
-    size_t offset = 6;
-
-    oscc_result_t ret = get_wheel_speed(frame, wheel_speed_right_rear, offset);
-
-    return ret;
+    return get_obd_signal(frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_REAR, wheel_speed_right_rear);
 }
 
 
@@ -1129,11 +6645,7 @@ oscc_result_t get_wheel_speed_left_rear(
     struct can_frame const * const frame,
     double * wheel_speed_left_rear)
 {
-    size_t offset = 4;
-
-    oscc_result_t ret = get_wheel_speed(frame, wheel_speed_left_rear, offset);
-
-    return ret;
+    return get_obd_signal(frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_REAR, wheel_speed_left_rear);
 }
 
 
@@ -1141,11 +6653,7 @@ oscc_result_t get_wheel_speed_right_front(
     struct can_frame const * const frame,
     double * wheel_speed_right_front)
 {
-    size_t offset = 2;
-
-    oscc_result_t ret = get_wheel_speed(frame, wheel_speed_right_front, offset);
-
-    return ret;
+    return get_obd_signal(frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_RIGHT_FRONT, wheel_speed_right_front);
 }
 
 
@@ -1153,11 +6661,7 @@ oscc_result_t get_wheel_speed_left_front(
     struct can_frame const * const frame,
     double * wheel_speed_left_front)
 {
-    size_t offset = 0;
-
-    oscc_result_t ret = get_wheel_speed(frame, wheel_speed_left_front, offset);
-
-    return ret;
+    return get_obd_signal(frame, OSCC_OBD_SIGNAL_WHEEL_SPEED_LEFT_FRONT, wheel_speed_left_front);
 }
 
 
@@ -1165,21 +6669,7 @@ oscc_result_t get_steering_wheel_angle(
     struct can_frame const * const frame,
     double * steering_wheel_angle)
 {
-    if((frame == NULL) || (steering_wheel_angle == NULL))
-    {
-        return OSCC_ERROR;
-    }
-
-    if(frame->can_id != KIA_SOUL_OBD_STEERING_WHEEL_ANGLE_CAN_ID)
-    {
-        return OSCC_ERROR;
-    }
-
-    int16_t raw = (frame->data[1] << 8) | frame->data[0];
-
-    *steering_wheel_angle = -((double)raw * KIA_SOUL_OBD_STEERING_ANGLE_SCALAR);
-
-    return OSCC_OK;
+    return get_obd_signal(frame, OSCC_OBD_SIGNAL_STEERING_WHEEL_ANGLE, steering_wheel_angle);
 }
 
 
@@ -1187,25 +6677,5 @@ oscc_result_t get_brake_pressure(
     struct can_frame const * const frame,
     double * brake_pressure)
 {
-    if((frame == NULL) || (brake_pressure == NULL))
-    {
-        return OSCC_ERROR;
-    }
-
-    if(frame->can_id != KIA_SOUL_OBD_BRAKE_PRESSURE_CAN_ID)
-    {
-        return OSCC_ERROR;
-    }
-
-#ifdef KIA_NIRO
-    double scale = 40.0;
-    uint16_t raw = ((frame->data[4] & 0x0F) << 8) | frame->data[3];
-#else
-    double scale = 10.0;
-    uint16_t raw = ((frame->data[5] & 0x0F) << 8) | frame->data[4];
-#endif
-
-    *brake_pressure = (double)raw / scale;
-
-    return OSCC_OK;
+    return get_obd_signal(frame, OSCC_OBD_SIGNAL_BRAKE_PRESSURE, brake_pressure);
 }
@@ -0,0 +1,15 @@
+/**
+ * @file vehicles/kia_soul_ev.c
+ * @brief OBD signal tables of the Kia Soul EV.
+ *
+ * Each vehicle's tables live in their own file because every vehicle header
+ * defines the same macro names.
+ */
+
+
+#include "obd_signals.h"
+#include "vehicles/kia_soul_ev.h"
+#include "internal/obd_decoder.h"
+
+
+OBD_VEHICLE_DEFINE( obd_vehicle_kia_soul_ev, KIA_SOUL_OBD_FRAMES )